@@ -1,7 +1,21 @@
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
 #include <Preferences.h>
+#include <sys/time.h>
 #include "si4703/Si4703.h"
+#include "si4703/Si4703Scan.h"
+#include "si4703/BandMap.h"
+#include "si4703/RdsDecoder.h"
+#include "si4703/AfFollower.h"
+#include "si4703/StationCache.h"
+
+// Surowe grupy RDS binarnie na UART (tools/rds_replay.cpp): kompilowac z -DRDS_LOG_ENABLED=1
+#ifndef RDS_LOG_ENABLED
+  #define RDS_LOG_ENABLED 0
+#endif
+#if RDS_LOG_ENABLED
+  #include "si4703/RdsLog.h"
+#endif
 
 // ================= LOGI =================
 #define LOG_BAUD 115200
@@ -17,7 +31,8 @@ LiquidCrystal_I2C lcd(0x27, 20, 4);
 
 // ================= RADIO =================
 #define RADIO_RST 6
-Si4703 radio(RADIO_RST);
+#define RADIO_INT 12   // Si4703 GPIO2 (przerwanie STC)
+Si4703 radio(RADIO_RST, SDA_PIN, SCL_PIN, RADIO_INT);
 
 // ================= ENKODER =================
 #define ENC_A   9
@@ -37,11 +52,20 @@ Preferences prefs;
 static const char* PREF_NS   = "fmradio";
 static const char* PREF_FREQ = "freq";
 static const char* PREF_VOL  = "vol";
+static const char* PREF_STATIONS = "stations";
+static const char* PREF_BANDMAP  = "bandmap";
+static const char* PREF_MAPCLK   = "mapclk";
+static const char* PREF_SMART    = "smart";
+static const char* PREF_STCACHE  = "stcache";
 
 bool settingsDirty = false;
 unsigned long lastUserChangeMs = 0;
 const unsigned long SAVE_DELAY_MS = 1500;  // zapis po chwili bez kręcenia
 
+// ================= CACHE STATUSU RADIA =================
+const uint16_t STATUS_MAX_AGE_MS = 50;     // RSSI/stereo/kanal moga miec do 50 ms
+const unsigned long STATS_LOG_MS = 30000;  // co ile logowac statystyki I2C
+
 // ================= CACHE =================
 int lastFreq = -1;
 int lastRSSI = -1;
@@ -52,6 +76,100 @@ bool lastStereo = false;
 int currentFreq = 10240;
 int currentVol  = 8;
 
+// ================= STROJENIE =================
+// Szybkie krecenie: posrednie czestotliwosci sa pomijane, stroimy tylko ostatni cel
+const unsigned long TUNE_SETTLE_MS = 15;  // uspokojenie enkodera przed strojeniem
+bool tunePending = false;                 // currentFreq czeka na wyslanie do radia
+int tunedFreq = -1;                       // ostatnio wyslana do radia czestotliwosc
+unsigned long lastDetentMs = 0;
+uint32_t tunesIssued = 0;                 // strojenia wyslane do radia
+uint32_t tunesDropped = 0;                // cele nadpisane przed wyslaniem
+
+// ================= RDS =================
+const unsigned long RDS_POLL_MS = 40;     // grupa co 87.6 ms, RDSR trzyma sie ~40 ms
+RdsDecoder rds;
+const RdsPolicy RDS_POLICY = {
+  RDS_ACCEPT_VOTE,   // bloki z poprawionymi bledami RT musza sie powtorzyc
+  { RDS_BLER_3_5,    // A (PI i tak wymaga powtorzenia)
+    RDS_BLER_1_2,    // B (typ grupy i adres segmentu - ostrozniej)
+    RDS_BLER_3_5,    // C
+    RDS_BLER_3_5 }   // D
+};
+const bool RDS_STATS_LOG = true;          // grupy odebrane/przyjete/odrzucone co sekunde
+const char* TITLE_DEFAULT = "   ESP32 FM RADIO   ";
+const char* TITLE_CLOCK   = "ESP32 FM RADIO";     // + " HH:MM", gdy zegar ustawiony
+
+// Zegar z RDS (grupa 4A: UTC + przesuniecie lokalne)
+const long CLOCK_CORRECT_MS = 500;        // korekta zegara systemowego od takiego odchylenia
+const long CLOCK_SANITY_MS = 600000;      // CT rozny od zegara o wiecej: tylko jako para zgodnych CT
+const long CT_PAIR_MIN_MS = 50000;        // zegar przestawiany tylko po dwoch kolejnych CT
+const long CT_PAIR_MAX_MS = 70000;        // (nadawanych co minute) ...
+const long CT_AGREE_MS = 2000;            // ... zgodnych ze soba z taka dokladnoscia
+bool clockValid = false;                  // zegar ustawiony z RDS
+int8_t clockOffset = 0;                   // przesuniecie lokalne (polgodziny)
+unsigned long clockSetMs = 0;             // millis() ostatniej korekty
+uint32_t clockUpdates = 0;                // korekty zegara
+uint32_t clockRejected = 0;               // CT sprzeczne z ustawionym zegarem
+long long ctPrevUtcMs = 0;                // poprzedni CT (UTC w ms, 0 = brak) ...
+unsigned long ctPrevMs = 0;               // ... i millis() jego odbioru
+
+// Linia tytulu: PS, co jakis czas przewijany RadioText
+const unsigned long TITLE_PS_MS = 6000;     // PS na linii tytulu miedzy przewinieciami RT
+const unsigned long TITLE_SCROLL_MS = 400;  // krok przewijania RT
+const int TITLE_SCROLL_PAUSE = 4;           // kroki postoju na poczatku i koncu RT
+char titleShadow[21];                       // zawartosc linii tytulu na LCD
+bool titleRT = false;                       // linia pokazuje RT (a nie PS)
+int titleScroll = 0;
+uint16_t titleRTVersion = 0;
+unsigned long titleMs = 0;
+
+// ================= CACHE STACJI (PI -> PS/PTY/RT) =================
+StationCache stationCache;
+uint16_t cachedPI = 0;                    // PI przewidziany z mapy pasma dla strojonej czestotliwosci
+
+// ================= AF (czestotliwosci alternatywne) =================
+AfFollower af(radio);
+const bool AF_FOLLOW = true;              // przejscie na AF przy slabym sygnale
+const uint8_t AF_RSSI_MIN = 20;           // ponizej: szukamy lepszego nadajnika tej samej stacji
+const uint8_t AF_MARGIN = 6;              // AF musi byc o tyle mocniejszy
+
+// ================= KOMUNIKATY DROGOWE (TA/TP) =================
+const bool TA_MODE = true;                // komunikat na stacji TP: glosniej + ekran komunikatu
+const int TA_VOLUME = 12;                 // glosnosc komunikatu (nie mniejsza niz ustawiona)
+bool taActive = false;
+
+// ================= SEEK =================
+bool seekActive = false;
+const unsigned long SEEK_UI_MS = 100;   // animacja FREQ podczas szukania
+
+// ================= SKAN PASMA =================
+StationTable stations;
+Si4703Scanner scanner(radio, stations);
+const uint16_t SCAN_PI_DWELL_MS = 500;  // czekanie na PI (RDS) na kazdej stacji
+const uint8_t SCAN_MODE = SCAN_SWEEP;   // SCAN_SWEEP (szybki, programowy) lub SCAN_SEEK
+const ScanCriteria SCAN_CRITERIA = {
+  18,     // rssiMin: ponizej - kanal martwy, odrzucany od razu
+  true,   // localPeak: tylko lokalne maksima RSSI
+  false   // requireStereo
+};
+
+// ================= MAPA PASMA =================
+BandMap bandMap;
+const uint8_t BANDMAP_GOOD_RSSI = 25;            // kanal "dobry" od tego RSSI
+const unsigned long BANDMAP_SAVE_MS = 600000;    // zapis mapy do NVS najwyzej co 10 min
+bool smartTune = false;                          // enkoder skacze po dobrych kanalach
+
+// ================= WIDMO PASMA =================
+// 20 kolumn x 4 wiersze, 8 pikseli na wiersz = 32 poziomy; kolumna = max RSSI ~10 kanalow
+const uint8_t SPECTRUM_COLS = 20;
+const uint8_t SPECTRUM_ROWS = 4;
+const uint8_t SPECTRUM_LEVELS = SPECTRUM_ROWS * 8;
+const uint8_t SPECTRUM_RSSI_FULL = 64;   // RSSI odpowiadajace pelnej wysokosci
+bool spectrumActive = false;
+uint8_t spectrumLevel[SPECTRUM_COLS];    // wysokosc narysowana na LCD
+uint8_t spectrumPeak[SPECTRUM_COLS];     // max RSSI kolumny w biezacym przebiegu
+int spectrumCol = -1;                    // kolumna ostatniej probki
+
 // ================= CUSTOM CHARS =================
 byte barFull[8] = {
   B11111,B11111,B11111,B11111,
@@ -98,6 +216,7 @@ bool loadSettings()
 
   int savedFreq = prefs.getInt(PREF_FREQ, currentFreq);
   int savedVol  = prefs.getInt(PREF_VOL, currentVol);
+  smartTune     = prefs.getBool(PREF_SMART, smartTune);
   prefs.end();
 
   bool corrected = false;
@@ -136,6 +255,7 @@ bool saveSettingsNow()
 
   size_t f = prefs.putInt(PREF_FREQ, currentFreq);
   size_t v = prefs.putInt(PREF_VOL, currentVol);
+  prefs.putBool(PREF_SMART, smartTune);
   prefs.end();
 
   if (f == 0 || v == 0) {
@@ -150,6 +270,127 @@ bool saveSettingsNow()
   return true;
 }
 
+// Tabela stacji ze skanu (blob w NVS)
+bool loadStations()
+{
+  if (!prefs.begin(PREF_NS, true)) {
+    LOGE("Nie mozna otworzyc Preferences do odczytu");
+    return false;
+  }
+
+  static StationInfo buf[StationTable::CAPACITY];
+  size_t len = prefs.getBytesLength(PREF_STATIONS);
+  size_t n = 0;
+  if (len > 0 && len <= sizeof(buf) && len % sizeof(StationInfo) == 0) {
+    n = prefs.getBytes(PREF_STATIONS, buf, len) / sizeof(StationInfo);
+  }
+  prefs.end();
+
+  stations.load(buf, n);
+  LOGI("Wczytano tabele stacji: %u", stations.count());
+  return true;
+}
+
+bool saveStations()
+{
+  if (!prefs.begin(PREF_NS, false)) {
+    LOGE("Nie mozna otworzyc Preferences do zapisu");
+    return false;
+  }
+
+  // Pusta tabela: putBytes(0 B) zwraca 0 i zostawia stary blob - usun go
+  bool ok;
+  if (stations.count() == 0) {
+    ok = prefs.remove(PREF_STATIONS) || !prefs.isKey(PREF_STATIONS);
+  } else {
+    ok = prefs.putBytes(PREF_STATIONS, stations.data(), stations.size()) == stations.size();
+  }
+  prefs.end();
+
+  if (!ok) {
+    LOGE("Blad zapisu tabeli stacji do NVS");
+    return false;
+  }
+  return true;
+}
+
+// Mapa pasma (blob w NVS) + zegar mapy, zeby "ostatnio widziany" przetrwal restart
+bool loadBandMap()
+{
+  if (!prefs.begin(PREF_NS, true)) {
+    LOGE("Nie mozna otworzyc Preferences do odczytu");
+    return false;
+  }
+
+  if (prefs.getBytesLength(PREF_BANDMAP) == bandMap.size()) {
+    prefs.getBytes(PREF_BANDMAP, bandMap.raw(), bandMap.size());
+  }
+  bandMap.setClockBase(prefs.getUInt(PREF_MAPCLK, 0));
+  prefs.end();
+
+  bandMap.clearDirty();
+  return true;
+}
+
+bool saveBandMap()
+{
+  if (!prefs.begin(PREF_NS, false)) {
+    LOGE("Nie mozna otworzyc Preferences do zapisu");
+    return false;
+  }
+
+  size_t w = prefs.putBytes(PREF_BANDMAP, bandMap.data(), bandMap.size());
+  prefs.putUInt(PREF_MAPCLK, bandMap.now());
+  prefs.end();
+
+  if (w != bandMap.size()) {
+    LOGE("Blad zapisu mapy pasma do NVS");
+    return false;
+  }
+
+  bandMap.clearDirty();
+  LOGI("Zapisano mape pasma");
+  return true;
+}
+
+// Cache stacji RDS (blob w NVS), zapisywany razem z mapa pasma
+bool loadStationCache()
+{
+  if (!prefs.begin(PREF_NS, true)) {
+    LOGE("Nie mozna otworzyc Preferences do odczytu");
+    return false;
+  }
+
+  if (prefs.getBytesLength(PREF_STCACHE) == stationCache.size()) {
+    prefs.getBytes(PREF_STCACHE, stationCache.raw(), stationCache.size());
+  }
+  prefs.end();
+
+  stationCache.rebuild();
+  LOGI("Cache stacji: %u wpisow", stationCache.count());
+  return true;
+}
+
+bool saveStationCache()
+{
+  if (!prefs.begin(PREF_NS, false)) {
+    LOGE("Nie mozna otworzyc Preferences do zapisu");
+    return false;
+  }
+
+  size_t w = prefs.putBytes(PREF_STCACHE, stationCache.data(), stationCache.size());
+  prefs.end();
+
+  if (w != stationCache.size()) {
+    LOGE("Blad zapisu cache stacji do NVS");
+    return false;
+  }
+
+  stationCache.clearDirty();
+  LOGI("Zapisano cache stacji (%u wpisow)", stationCache.count());
+  return true;
+}
+
 void markSettingsDirty()
 {
   settingsDirty = true;
@@ -157,9 +398,8 @@ void markSettingsDirty()
 }
 
 // ================= BEZPIECZNE ODCZYTY =================
-int safeGetChannel()
+int safeChannel(int ch)
 {
-  int ch = radio.getChannel();
   static unsigned long lastWarn = 0;
 
   if (ch < FREQ_MIN || ch > FREQ_MAX) {
@@ -174,7 +414,7 @@ int safeGetChannel()
 
 int safeGetVolume()
 {
-  int vol = radio.getVolume();
+  int vol = radio.getVolume(); // z cache rejestrow sterujacych, bez I2C
   static unsigned long lastWarn = 0;
 
   if (vol < VOL_MIN || vol > VOL_MAX) {
@@ -187,9 +427,8 @@ int safeGetVolume()
   return vol;
 }
 
-int safeGetRSSI()
+int safeRSSI(int rssi)
 {
-  int rssi = radio.getRSSI();
   static unsigned long lastWarn = 0;
 
   if (rssi < 0 || rssi > 127) {
@@ -202,9 +441,13 @@ int safeGetRSSI()
   return rssi;
 }
 
-bool safeGetStereo()
+// Jeden odczyt statusu radia (RSSI, stereo, kanal z tej samej probki)
+Si4703::Status safePollStatus()
 {
-  return radio.getST();
+  Si4703::Status st = radio.pollStatus();
+  st.channel = safeChannel(st.channel);
+  st.rssi    = safeRSSI(st.rssi);
+  return st;
 }
 
 // ================= LCD =================
@@ -214,11 +457,47 @@ void createCustomChars()
   lcd.createChar(1, barEmpty);
 }
 
+// Znaki 0..7 jako slupki wysokosci 1..8 px (nadpisuja barFull/barEmpty do wyjscia z widma)
+void createSpectrumChars()
+{
+  for (uint8_t h = 1; h <= 8; h++) {
+    byte glyph[8];
+    for (uint8_t y = 0; y < 8; y++) glyph[y] = (y >= 8 - h) ? B11111 : B00000;
+    lcd.createChar(h - 1, glyph);
+  }
+}
+
+// Linia tytulu (dokladnie 20 znakow): wysylane sa tylko znaki rozne od tych na LCD
+void drawTitle(const char* title)
+{
+  int i = 0;
+  while (i < 20) {
+    if (title[i] == titleShadow[i]) {
+      i++;
+      continue;
+    }
+    lcd.setCursor(i, 0);
+    while (i < 20 && title[i] != titleShadow[i]) {
+      lcd.print(title[i]);
+      titleShadow[i] = title[i];
+      i++;
+    }
+  }
+}
+
 void drawStaticUI()
 {
   lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("   ESP32 FM RADIO   ");
+  memset(titleShadow, ' ', 20);
+  titleShadow[20] = 0;
+  drawTitle(TITLE_DEFAULT);
+}
+
+// Znacznik trybu smart tune w ostatniej kolumnie linii FREQ
+void drawSmartMarker()
+{
+  lcd.setCursor(19, 1);
+  lcd.print(smartTune ? "*" : " ");
 }
 
 // ================= UI (1:1 jak oryginał) =================
@@ -233,12 +512,12 @@ void updateFrequency(int freq)
   lcd.print(mhz, 2);
   lcd.print(" MHz   ");  // jak w oryginale
 
+  drawSmartMarker();
   lastFreq = freq;
 }
 
-void updateSignal()
+void updateSignal(int rssi)
 {
-  int rssi = safeGetRSSI();
   if (rssi == lastRSSI) return;
 
   int bars = constrain(map(rssi, 0, 75, 0, 10), 0, 10);
@@ -259,9 +538,8 @@ void updateSignal()
   lastRSSI = rssi;
 }
 
-void updateStereo()
+void updateStereo(bool stereo)
 {
-  bool stereo = safeGetStereo();
   if (stereo == lastStereo) return;
 
   lcd.setCursor(0, 3);
@@ -285,6 +563,307 @@ void updateVolume()
   lastVolume = vol;
 }
 
+// Odswiezenie statusow UI z jednego odczytu radia
+void refreshStatus(const Si4703::Status& st)
+{
+  updateFrequency(st.channel);
+  updateSignal(st.rssi);
+  updateStereo(st.stereo);
+  updateVolume();
+
+  bandMap.update(st.channel, st.rssi, st.stereo);
+}
+
+// ================= RDS =================
+// Czas lokalny "HH:MM" z zegara systemowego (false, dopoki RDS go nie ustawil)
+bool formatClock(char* out)
+{
+  if (!clockValid) return false;
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  long local = (long)(tv.tv_sec % 86400) + clockOffset * 1800L + 86400L;
+  snprintf(out, 6, "%02ld:%02ld", (local / 3600) % 24, (local / 60) % 60);
+  return true;
+}
+
+// Znaki RDS spoza ASCII: LCD ma inna tablice znakow
+char lcdChar(char c)
+{
+  return (c >= 0x20 && c <= 0x7E) ? c : ' ';
+}
+
+// Linia tytulu: PS wysrodkowany (bez PS - tytul domyslny), co TITLE_PS_MS
+// przewijany RadioText; dluzszy niz 20 znakow przesuwa sie o znak na krok
+void serviceTitle()
+{
+  static uint16_t loggedPS = 0, loggedRT = 0;
+  if (rds.hasPS() && rds.getPSVersion() != loggedPS) {
+    LOGI("RDS: PS='%s' PI=%04X PTY=%u TP=%d TA=%d",
+         rds.getPS(), rds.getPI(), rds.getPTY(), rds.getTP(), rds.getTA());
+    loggedPS = rds.getPSVersion();
+  }
+  if (rds.getRT()[0] && rds.getRTVersion() != loggedRT) {
+    LOGI("RDS: RT='%s'", rds.getRT());
+    loggedRT = rds.getRTVersion();
+  }
+
+  char line[21];
+  memset(line, ' ', 20);
+  line[20] = 0;
+
+  // Dopoki RDS nie potwierdzi, nazwa i RT z cache stacji
+  const StationCache::Entry* cached = stationCache.find(rds.getPI() ? rds.getPI() : cachedPI);
+  const char* psText = rds.hasPS() ? rds.getPS() : (cached && cached->ps[0] ? cached->ps : 0);
+
+  const char* rt = rds.getRT()[0] ? rds.getRT() : (cached ? cached->rt : "");
+  int rtLen = strlen(rt);
+
+  if (!titleRT && rtLen > 0 && millis() - titleMs > TITLE_PS_MS) {
+    titleRT = true;
+    titleScroll = 0;
+    titleRTVersion = rds.getRTVersion();
+    titleMs = millis();
+  }
+
+  if (titleRT) {
+    // Nowy komunikat w trakcie przewijania: od poczatku
+    if (rds.getRTVersion() != titleRTVersion) {
+      titleScroll = 0;
+      titleRTVersion = rds.getRTVersion();
+      titleMs = millis();
+    }
+    if (millis() - titleMs >= TITLE_SCROLL_MS) {
+      titleScroll++;
+      titleMs = millis();
+    }
+
+    int maxOff = rtLen > 20 ? rtLen - 20 : 0;
+    if (rtLen > 0 && titleScroll <= maxOff + 2 * TITLE_SCROLL_PAUSE) {
+      int off = constrain(titleScroll - TITLE_SCROLL_PAUSE, 0, maxOff);
+      int start = rtLen < 20 ? (20 - rtLen) / 2 : 0;
+      for (int i = 0; i < 20 && off + i < rtLen; i++) line[start + i] = lcdChar(rt[off + i]);
+      drawTitle(line);
+      return;
+    }
+
+    titleRT = false;
+    titleMs = millis();
+  }
+
+  // Z zegarem: PS wysrodkowany w kolumnach 0..14, godzina w 15..19
+  char hhmm[6];
+  bool hasClock = formatClock(hhmm);
+
+  if (!psText) {
+    if (!hasClock) {
+      drawTitle(TITLE_DEFAULT);
+      return;
+    }
+    memcpy(line, TITLE_CLOCK, strlen(TITLE_CLOCK));
+  } else {
+    int start = hasClock ? 3 : 6;
+    for (int i = 0; i < RdsDecoder::PS_LEN && psText[i]; i++) line[start + i] = lcdChar(psText[i]);
+  }
+  if (hasClock) memcpy(line + 15, hhmm, 5);
+  drawTitle(line);
+}
+
+// Nowy CT z RDS: ustawienie / korekta zegara systemowego i pomiar dryfu
+void serviceClock()
+{
+  static uint16_t seenCT = 0;
+  if (!rds.hasCT() || rds.getCTVersion() == seenCT) return;
+  seenCT = rds.getCTVersion();
+
+  // CT opisuje poczatek minuty w chwili odbioru grupy; przesun na teraz
+  long long ctUtcMs = (long long)rds.getCTUtc() * 1000;
+  unsigned long ctAt = rds.getCTMs();
+  long long ctMs = ctUtcMs + (millis() - ctAt);
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  long long sysMs = (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  long long diff = sysMs - ctMs;
+
+  // Pojedyncza przeklamana grupa 4A (np. bit godziny) nie przestawia zegara;
+  // para zgodnych CT (jak przy pierwszym ustawieniu) moze - inaczej zly czas
+  // pierwszej stacji blokowalby poprawny do restartu
+  bool insane = clockValid && (diff > CLOCK_SANITY_MS || diff < -CLOCK_SANITY_MS);
+  if (insane) {
+    clockRejected++;
+    LOGW("RDS CT: rozni sie od zegara o %lld s", diff / 1000);
+  } else if (clockValid) {
+    unsigned long since = millis() - clockSetMs;
+    LOGI("RDS CT: odchylenie zegara %lld ms po %lu s (%.1f ppm)",
+         diff, since / 1000, since > 0 ? diff * 1000000.0 / since : 0.0);
+    if (diff < CLOCK_CORRECT_MS && diff > -CLOCK_CORRECT_MS) {
+      clockOffset = rds.getCTOffset();
+      ctPrevUtcMs = ctUtcMs;
+      ctPrevMs = ctAt;
+      return;
+    }
+  }
+
+  // Krok zegara dopiero, gdy poprzedni CT sprzed ok. minuty sie z tym zgadza
+  bool confirmed = false;
+  if (ctPrevUtcMs != 0) {
+    long gap = (long)(ctAt - ctPrevMs);
+    long long skew = (ctUtcMs - ctPrevUtcMs) - gap;
+    confirmed = gap >= CT_PAIR_MIN_MS && gap <= CT_PAIR_MAX_MS &&
+                skew < CT_AGREE_MS && skew > -CT_AGREE_MS;
+  }
+  ctPrevUtcMs = ctUtcMs;
+  ctPrevMs = ctAt;
+  if (!confirmed) {
+    LOGI("RDS CT: czekam na potwierdzenie kolejnym CT");
+    return;
+  }
+  if (insane) LOGW("RDS CT: dwa zgodne CT, zegar przestawiony o %lld s", -diff / 1000);
+
+  clockOffset = rds.getCTOffset();
+  tv.tv_sec = (time_t)(ctMs / 1000);
+  tv.tv_usec = (suseconds_t)(ctMs % 1000) * 1000;
+  settimeofday(&tv, NULL);
+
+  clockValid = true;
+  clockSetMs = millis();
+  clockUpdates++;
+  LOGI("RDS CT: zegar ustawiony (UTC%+d min, korekta nr %lu)",
+       clockOffset * 30, (unsigned long)clockUpdates);
+}
+
+// Ramka binarna grupy RDS na UART (miedzy liniami logu; parser sam sie synchronizuje)
+void logRDSGroup(const RdsGroup& g)
+{
+#if RDS_LOG_ENABLED
+  static uint32_t prevMs = 0;
+  uint8_t frame[RdsLog::FRAME_LEN];
+  RdsLog::encode(g, prevMs, frame);
+  Serial.write(frame, sizeof(frame));
+  prevMs = g.ms;
+#else
+  (void)g;
+#endif
+}
+
+// ================= TA =================
+// Flaga TA sprawdzana po kazdej grupie z bufora RDS, nie co 500 ms
+void startTA()
+{
+  taActive = true;
+  if (currentVol < TA_VOLUME) radio.setVolume(TA_VOLUME);  // bez zapisu do NVS
+
+  lcd.setCursor(0, 1);
+  lcd.print(" KOMUNIKAT DROGOWY  ");
+  char line[21];
+  memset(line, ' ', 20);
+  line[20] = 0;
+  memcpy(line, "STACJA: ", 8);
+  if (rds.hasPS()) {
+    const char* ps = rds.getPS();
+    for (int i = 0; i < RdsDecoder::PS_LEN && ps[i]; i++) line[8 + i] = lcdChar(ps[i]);
+  }
+  lcd.setCursor(0, 2);
+  lcd.print(line);
+  lcd.setCursor(0, 3);
+  lcd.print("             ");
+  lastVolume = -1;
+  updateVolume();
+
+  LOGI("TA: komunikat drogowy (PI %04X), glosnosc %d", rds.getPI(), safeGetVolume());
+}
+
+void endTA()
+{
+  taActive = false;
+  radio.setVolume(currentVol);
+
+  // Ekran komunikatu znika: wszystkie pola statusu do przerysowania
+  // (SYG i TRYB przy najblizszym odswiezeniu statusu)
+  lastFreq = -1;
+  lastRSSI = -1;
+  lastVolume = -1;
+  lastStereo = !lastStereo;
+  lcd.setCursor(0, 2);
+  lcd.print("                    ");
+  updateFrequency(currentFreq);
+  updateVolume();
+
+  LOGI("TA: koniec komunikatu, glosnosc %d", currentVol);
+}
+
+void serviceTA()
+{
+  bool ta = TA_MODE && rds.getTP() && rds.getTA();
+  if (ta && !taActive) startTA();
+  else if (!ta && taActive) endTA();
+}
+
+// Odczyt grup RDS, gdy radio stoi na stacji (jeden odczyt 6 slow na probe;
+// przy przerwaniu RDS grupy zbiera zadanie w tle, tu tylko oprozniamy bufor)
+void serviceRDS()
+{
+  static unsigned long lastPoll = 0;
+  if (millis() - lastPoll < RDS_POLL_MS) return;
+  lastPoll = millis();
+
+  radio.readRDS();
+
+  RdsGroup g;
+  while (radio.getRDSGroup(g)) {
+    logRDSGroup(g);
+    rds.feed(g);
+    serviceTA();
+  }
+
+  // Potwierdzona stacja: PI do mapy pasma, PS/PTY/RT do cache
+  static uint16_t storedPS = 0, storedRT = 0;
+  if (rds.getPI() != 0) {
+    bandMap.setPI(currentFreq, rds.getPI());
+    if (rds.hasPS() && (rds.getPSVersion() != storedPS || rds.getRTVersion() != storedRT)) {
+      stationCache.store(rds.getPI(), rds.getPS(), rds.getPTY(), rds.getRT());
+      storedPS = rds.getPSVersion();
+      storedRT = rds.getRTVersion();
+    }
+  }
+
+  serviceClock();
+  serviceTitle();
+
+  // Statystyki do strojenia RDS_POLICY (tylko gdy cokolwiek przyszlo)
+  static unsigned long lastStats = 0;
+  static uint32_t lastGroups = 0, lastAccepted = 0;
+  if (millis() - lastStats >= 1000) {
+    uint32_t groups = rds.getGroups() - lastGroups;
+    uint32_t accepted = rds.getAccepted() - lastAccepted;
+    if (RDS_STATS_LOG && groups > 0) {
+      LOGI("RDS/s: odebrane=%lu przyjete=%lu odrzucone=%lu",
+           (unsigned long)groups, (unsigned long)accepted, (unsigned long)(groups - accepted));
+    }
+    lastGroups = rds.getGroups();
+    lastAccepted = rds.getAccepted();
+    lastStats = millis();
+  }
+}
+
+// Nowa stacja: zapomnij RDS poprzedniej (takze grupy czekajace w buforze);
+// jesli mapa pasma zna PI tej czestotliwosci, nazwa od razu z cache stacji
+void restartRDS(int freq)
+{
+  RdsGroup g;
+  while (radio.getRDSGroup(g)) {}
+  rds.reset();
+  if (taActive) endTA();
+
+  const BandMapEntry* m = bandMap.get(freq);
+  cachedPI = m ? m->pi : 0;
+  stationCache.touch(cachedPI);
+  titleRT = false;
+  titleMs = millis();
+  serviceTitle();
+}
+
 // ================= ENCODER =================
 bool readEncButtonHeld()
 {
@@ -304,6 +883,65 @@ bool readEncButtonHeld()
   return stable;
 }
 
+// Klik = wcisniecie i puszczenie przycisku bez krecenia enkoderem
+bool buttonUsed = false;   // przycisk juz wykorzystany (glosnosc / przerwanie szukania)
+
+bool readEncClick(bool held, int det)
+{
+  static bool wasHeld = false;
+  bool click = false;
+
+  if (held && det != 0) buttonUsed = true;
+
+  if (wasHeld && !held) {
+    click = !buttonUsed;
+    buttonUsed = false;
+  }
+  wasHeld = held;
+  return click;
+}
+
+// Liczba klikniec w serii (zglaszana po przerwie CLICK_GAP_MS, inaczej 0)
+const unsigned long CLICK_GAP_MS = 350;
+
+uint8_t readEncClicks(bool click)
+{
+  static uint8_t count = 0;
+  static unsigned long lastClickMs = 0;
+
+  if (click) {
+    count++;
+    lastClickMs = millis();
+    return 0;
+  }
+
+  if (count > 0 && (millis() - lastClickMs > CLICK_GAP_MS)) {
+    uint8_t n = count;
+    count = 0;
+    return n;
+  }
+  return 0;
+}
+
+// Dlugie przytrzymanie przycisku bez krecenia (zglaszane raz)
+const unsigned long LONG_PRESS_MS = 2000;
+
+bool readEncLongPress(bool held)
+{
+  static bool wasHeld = false;
+  static unsigned long pressedMs = 0;
+  bool fire = false;
+
+  if (held && !wasHeld) pressedMs = millis();
+
+  if (held && !buttonUsed && (millis() - pressedMs >= LONG_PRESS_MS)) {
+    fire = true;
+    buttonUsed = true;  // puszczenie nie bedzie klikiem
+  }
+  wasHeld = held;
+  return fire;
+}
+
 // -1/0/+1 na detent
 int readEncoderDetent()
 {
@@ -334,21 +972,341 @@ int readEncoderDetent()
   return 0;
 }
 
+// Zmiana czestotliwosci z enkodera: LCD od razu, radio stroi tylko najnowszy cel
 void setFrequency(int freq)
 {
   freq = constrain(freq, FREQ_MIN, FREQ_MAX);
   if (freq == currentFreq) return;
 
+  if (tunePending) tunesDropped++;  // poprzedni cel nie zdazyl trafic do radia
+
   currentFreq = freq;
-  radio.setChannel(currentFreq);
+  tunePending = true;
+  lastDetentMs = millis();
+
+  lastFreq = -1;
+  updateFrequency(currentFreq);
+  markSettingsDirty();
+}
+
+// Obsluga strojenia w tle (wywolywane w kazdym obiegu loop)
+void serviceTune()
+{
+  uint8_t state = radio.pollTune();
+
+  if (state == TUNE_DONE) {
+    bandMap.update(tunedFreq, radio.getTuneRSSI(), radio.getTuneST());
+    LOGI("Ustawiono stacje: %d (%.2f MHz)", tunedFreq, tunedFreq / 100.0);
+  } else if (state == TUNE_TIMEOUT) {
+    LOGW("Timeout strojenia: %d (%.2f MHz)", tunedFreq, tunedFreq / 100.0);
+  }
 
-  LOGI("Ustawiono stacje: %d (%.2f MHz)", currentFreq, currentFreq / 100.0);
+  // Nowe strojenie dopiero po zakonczeniu poprzedniego i krotkim uspokojeniu enkodera
+  if (tunePending && !radio.isTuning() && (millis() - lastDetentMs >= TUNE_SETTLE_MS)) {
+    tunedFreq = currentFreq;
+    radio.beginTune(tunedFreq);
+    tunePending = false;
+    tunesIssued++;
+    restartRDS(tunedFreq);
+  }
+}
+
+// ================= SEEK =================
+void startSeek()
+{
+  tunePending = false;
+  radio.beginSeek(Si4703::SEEK_UP);
+  seekActive = true;
+  restartRDS(0);
+  LOGI("Szukanie stacji w gore od %.2f MHz", currentFreq / 100.0);
+}
+
+// Przyjecie stacji, na ktorej radio zakonczylo (lub przerwalo) szukanie
+void finishSeek()
+{
+  seekActive = false;
+  currentFreq = safeChannel(radio.getChannel());
+  tunedFreq = currentFreq;
+  restartRDS(currentFreq);   // nazwa z cache, jesli stacja znana
 
   lastFreq = -1;
   updateFrequency(currentFreq);
   markSettingsDirty();
 }
 
+void stopSeek()
+{
+  radio.cancelTune();
+  finishSeek();
+  LOGI("Szukanie przerwane na %.2f MHz", currentFreq / 100.0);
+}
+
+void serviceSeek()
+{
+  uint8_t state = radio.pollTune();
+
+  if (state == TUNE_TUNING) {
+    // FREQ pokazuje aktualnie mijany kanal
+    static unsigned long lastUi = 0;
+    if (millis() - lastUi > SEEK_UI_MS) {
+      updateFrequency(safeChannel(radio.getSeekProgress()));
+      lastUi = millis();
+    }
+    return;
+  }
+
+  finishSeek();
+
+  if (state == TUNE_DONE) {
+    bandMap.update(currentFreq, radio.getTuneRSSI(), radio.getTuneST());
+    LOGI("Znaleziono stacje: %.2f MHz", currentFreq / 100.0);
+  } else if (state == TUNE_BANDLIMIT) {
+    LOGW("Szukanie: brak stacji do konca pasma (%.2f MHz)", currentFreq / 100.0);
+  } else if (state == TUNE_TIMEOUT) {
+    LOGW("Timeout szukania na %.2f MHz", currentFreq / 100.0);
+  }
+}
+
+// ================= SKAN PASMA =================
+void startScan()
+{
+  tunePending = false;
+  if (taActive) endTA();
+  scanner.setPiDwell(SCAN_PI_DWELL_MS);
+  scanner.setCriteria(SCAN_CRITERIA);
+  scanner.begin(SCAN_MODE);
+
+  drawTitle("  SKANOWANIE PASMA  ");
+  LOGI("Skan pasma: start (%s)", SCAN_MODE == SCAN_SWEEP ? "sweep" : "seek");
+}
+
+// Koniec (lub przerwanie) skanu: raport, zapis, powrot na poprzednia stacje.
+// Tabele stacji zapisuje tylko pelny skan; przerwany wraca do listy z NVS.
+void finishScan(bool completed)
+{
+  LOGI("Skan pasma (%s): %u stacji, %lu ms, %lu transakcji I2C",
+       SCAN_MODE == SCAN_SWEEP ? "sweep" : "seek", stations.count(), (unsigned long)scanner.getElapsedMs(),
+       (unsigned long)scanner.getTransactions());
+
+  for (int i = 0; i < stations.count(); i++) {
+    const StationInfo& st = stations.at(i);
+    LOGI("  %6.2f MHz  RSSI:%2u  %s  PI:%04X",
+         st.freq / 100.0, st.rssi, st.stereo ? "ST" : "MO", st.pi);
+  }
+
+  if (completed) saveStations();
+  else          loadStations();
+  saveBandMap();
+  if (stationCache.isDirty()) saveStationCache();
+
+  drawTitle(TITLE_DEFAULT);
+  tunePending = true;       // wroc na stacje sprzed skanu
+  lastDetentMs = 0;
+  lastFreq = -1;
+  updateFrequency(currentFreq);
+}
+
+void stopScan()
+{
+  scanner.cancel();
+  LOGI("Skan pasma przerwany");
+  finishScan(false);
+}
+
+void serviceScan()
+{
+  if (scanner.poll()) {
+    static unsigned long lastUi = 0;
+    if (millis() - lastUi > SEEK_UI_MS) {
+      updateFrequency(safeChannel(scanner.getProgress()));
+      lastUi = millis();
+    }
+    return;
+  }
+  finishScan(true);
+}
+
+// ================= WIDMO PASMA =================
+void drawSpectrumColumn(uint8_t col, uint8_t level)
+{
+  for (uint8_t row = 0; row < SPECTRUM_ROWS; row++) {
+    int fill = (int)level - (SPECTRUM_ROWS - 1 - row) * 8;
+    lcd.setCursor(col, row);
+    if (fill <= 0) lcd.print(' ');
+    else           lcd.write((uint8_t)(constrain(fill, 1, 8) - 1));
+  }
+}
+
+// Probka z przebiegu skanera: rysowana od razu, tylko gdy zmienia wysokosc kolumny
+void onSpectrumSample(int freq, uint8_t rssi, bool stereo)
+{
+  int channels = (radio.getBandEnd() - radio.getBandStart()) / radio.getBandSpace() + 1;
+  int col = (freq - radio.getBandStart()) / radio.getBandSpace() * SPECTRUM_COLS / channels;
+  col = constrain(col, 0, SPECTRUM_COLS - 1);
+
+  // Pierwsza probka kolumny w tym przebiegu zastepuje wynik poprzedniego
+  if (col != spectrumCol) {
+    spectrumPeak[col] = rssi;
+    spectrumCol = col;
+  } else if (rssi > spectrumPeak[col]) {
+    spectrumPeak[col] = rssi;
+  }
+
+  uint8_t level = constrain((int)spectrumPeak[col], 0, (int)SPECTRUM_RSSI_FULL) * SPECTRUM_LEVELS / SPECTRUM_RSSI_FULL;
+  if (level != spectrumLevel[col]) {
+    drawSpectrumColumn(col, level);
+    spectrumLevel[col] = level;
+  }
+}
+
+void startSpectrum()
+{
+  tunePending = false;
+  if (taActive) endTA();
+  spectrumActive = true;
+  spectrumCol = -1;
+  memset(spectrumLevel, 0, sizeof(spectrumLevel));
+  memset(spectrumPeak, 0, sizeof(spectrumPeak));
+
+  lcd.clear();
+  createSpectrumChars();
+
+  scanner.setSampleHook(onSpectrumSample);
+  scanner.begin(SCAN_SPECTRUM);
+  LOGI("Widmo pasma: start");
+}
+
+void stopSpectrum()
+{
+  scanner.cancel();
+  scanner.setSampleHook(0);
+  spectrumActive = false;
+  LOGI("Widmo pasma: koniec");
+
+  // Przywroc zwykly ekran i wroc na stacje sprzed widma
+  createCustomChars();
+  drawStaticUI();
+  lastFreq = -1;
+  lastRSSI = -1;
+  lastVolume = -1;
+  lastStereo = !lastStereo;
+  updateFrequency(currentFreq);
+  updateVolume();
+
+  tunePending = true;
+  lastDetentMs = 0;
+}
+
+// Przebiegi pasma jeden za drugim, tempo w kanalach/s po kazdym
+void serviceSpectrum()
+{
+  if (scanner.poll()) return;
+
+  unsigned long ms = scanner.getElapsedMs();
+  LOGI("Widmo: %u kanalow w %lu ms (%.1f kan/s), %lu transakcji I2C",
+       scanner.getSamples(), ms,
+       ms > 0 ? scanner.getSamples() * 1000.0 / ms : 0.0,
+       (unsigned long)scanner.getTransactions());
+
+  spectrumCol = -1;
+  scanner.begin(SCAN_SPECTRUM);
+}
+
+// ================= AF =================
+// Koniec cyklu AF: przejecie nowej czestotliwosci albo powrot na stara
+void finishAF()
+{
+  // Grupy RDS z czestotliwosci sprawdzanych po drodze - do kosza
+  RdsGroup g;
+  while (radio.getRDSGroup(g)) {}
+
+  if (af.switched()) {
+    currentFreq = af.getFreq();
+    tunedFreq = currentFreq;
+    lastFreq = -1;
+    updateFrequency(currentFreq);
+    markSettingsDirty();
+    LOGI("AF: przejscie na %.2f MHz (PI %04X)", currentFreq / 100.0, rds.getPI());
+  } else {
+    LOGI("AF: brak lepszej czestotliwosci, zostaje %.2f MHz", currentFreq / 100.0);
+  }
+  LOGI("AF: cykl %lu ms, wyciszenie %lu ms",
+       (unsigned long)af.getLastCycleMs(), (unsigned long)af.getLastMuteMs());
+}
+
+void serviceAF()
+{
+  if (!af.poll()) finishAF();
+}
+
+// ================= SMART TUNE =================
+// Krok enkodera w trybie smart: od razu na nastepny znany dobry kanal z mapy pasma
+void smartStep(int det)
+{
+  int freq = currentFreq;
+
+  for (int i = 0; i < abs(det); i++) {
+    int next = bandMap.nextGood(freq, det);
+    if (next < 0) {
+      // brak znanych stacji w tym kierunku: zwykly krok
+      freq += (det > 0 ? FREQ_STEP : -FREQ_STEP);
+      break;
+    }
+    freq = next;
+  }
+  setFrequency(freq);
+}
+
+void toggleSmartTune()
+{
+  smartTune = !smartTune;
+  drawSmartMarker();
+  markSettingsDirty();
+  LOGI("Smart tune: %s", smartTune ? "wlaczony" : "wylaczony");
+}
+
+// ================= SZUKANIE PO PTY =================
+// Nastepna stacja tego samego typu programu (PTY): bez przeszukiwania pasma,
+// tylko kanaly o znanym PI (mapa pasma, wyniki skanu) i PTY z cache stacji
+uint16_t channelPI(int freq)
+{
+  const BandMapEntry* m = bandMap.get(freq);
+  if (m && m->pi) return m->pi;
+
+  for (int i = 0; i < stations.count(); i++) {
+    if (stations.at(i).freq == freq) return stations.at(i).pi;
+  }
+  return 0;
+}
+
+void ptySearch()
+{
+  uint8_t pty = rds.getPTY();
+  if (rds.getPI() == 0) {
+    const StationCache::Entry* e = stationCache.find(cachedPI);
+    pty = e ? e->pty : 0;
+  }
+  if (pty == 0) {
+    LOGW("PTY: nieznany typ programu biezacej stacji");
+    return;
+  }
+
+  int start = radio.getBandStart();
+  int span = (radio.getBandEnd() - start) / FREQ_STEP + 1;
+  int from = (currentFreq - start) / FREQ_STEP;
+
+  for (int n = 1; n < span; n++) {
+    int freq = start + ((from + n) % span) * FREQ_STEP;
+    const StationCache::Entry* e = stationCache.find(channelPI(freq));
+    if (e && e->pty == pty) {
+      LOGI("PTY %u: %.2f MHz (%s)", pty, freq / 100.0, e->ps);
+      setFrequency(freq);
+      return;
+    }
+  }
+  LOGI("PTY %u: brak innej znanej stacji", pty);
+}
+
 void setVolume(int vol)
 {
   vol = constrain(vol, VOL_MIN, VOL_MAX);
@@ -378,6 +1336,7 @@ void setup()
 
   // Wczytaj zapisane ustawienia usera
   loadSettings();
+  loadStations();
 
   // Wymuszenie trybu I2C
   pinMode(RADIO_RST, OUTPUT);
@@ -421,35 +1380,57 @@ void setup()
   radio.start();
   delay(200);
 
-  // Ustaw stan początkowy
+  // Mapa pasma: geometria z radia, zawartosc z NVS, uzupelniana przez skany
+  bandMap.begin(radio.getBandStart(), radio.getBandEnd(), radio.getBandSpace());
+  bandMap.setGoodRssi(BANDMAP_GOOD_RSSI);
+  loadBandMap();
+  loadStationCache();
+  scanner.setBandMap(&bandMap);
+
+  rds.setPolicy(RDS_POLICY);
+  af.setThreshold(AF_RSSI_MIN, AF_MARGIN);
+  LOGI("RDS: %s", radio.isRDSInterrupt() ? "przerwanie GPIO2 (zadanie w tle)" : "odpytywanie co 40 ms");
+
+  // Odczyty statusu z rzędu (UI, diagnostyka) obsluguje cache; STC zawsze swiezy
+  radio.setMaxAge(FIELD_RSSI, STATUS_MAX_AGE_MS);
+  radio.setMaxAge(FIELD_ST, STATUS_MAX_AGE_MS);
+  radio.setMaxAge(FIELD_CHANNEL, STATUS_MAX_AGE_MS);
+  radio.setMaxAge(FIELD_STATUS, STATUS_MAX_AGE_MS);
+
+  // Ustaw stan początkowy (jeden zapis rejestrow dla glosnosci i stacji)
+  radio.beginUpdate();
   radio.setVolume(currentVol);
   radio.setChannel(currentFreq);
+  radio.commit();
+  tunedFreq = currentFreq;
 
   LOGI("Przywrocono ustawienia po starcie: %.2f MHz, vol=%d",
        currentFreq / 100.0, currentVol);
 
   // WYMUSZENIE PIERWSZEGO RYSOWANIA
+  Si4703::Status boot = safePollStatus();
+
   lastFreq = -1;
   lastRSSI = -1;
   lastVolume = -1;
-  lastStereo = !safeGetStereo();  // wymusza wejście do updateStereo()
+  lastStereo = !boot.stereo;  // wymusza wejście do updateStereo()
 
-  updateFrequency(safeGetChannel());
-  updateSignal();
-  updateStereo();
-  updateVolume();
+  refreshStatus(boot);
 
   // Diagnostyka po starcie
-  int bootCh = safeGetChannel();
+  int bootCh = boot.channel;
   int bootVol = safeGetVolume();
-  int bootRssi = safeGetRSSI();
-  bool bootSt = safeGetStereo();
+  int bootRssi = boot.rssi;
+  bool bootSt = boot.stereo;
 
   LOGI("Stan radia po starcie:");
   LOGI("  Kanal : %d (%.2f MHz)", bootCh, bootCh / 100.0);
   LOGI("  Volume: %d", bootVol);
   LOGI("  RSSI  : %d", bootRssi);
   LOGI("  Tryb  : %s", bootSt ? "STEREO" : "MONO");
+  LOGI("  RDS   : %s, %s", radio.getRDSVerbose() ? "verbose (poziomy bledow BLER)" : "standard (BLER zawsze 0!)",
+       radio.isRDSInterrupt() ? "przerwanie GPIO2" : "odpytywanie");
+  LOGI("  I2C   : zaoszczedzono %lu B zapisu", (unsigned long)radio.getBytesSaved());
 }
 
 // ================= LOOP =================
@@ -457,13 +1438,92 @@ void loop()
 {
   bool volModeHeld = readEncButtonHeld();
   int det = readEncoderDetent();
+  uint8_t clicks = readEncClicks(readEncClick(volModeHeld, det));
+  bool longPress = readEncLongPress(volModeHeld);
+
+  static bool prevHeld = false;
+  bool pressed = volModeHeld && !prevHeld;
+  prevHeld = volModeHeld;
+
+  if (spectrumActive)
+  {
+    // Obrot enkodera lub wcisniecie przycisku zamyka widmo
+    if (det != 0 || pressed) {
+      stopSpectrum();
+      if (pressed) buttonUsed = true;
+      det = 0;
+    } else {
+      serviceSpectrum();
+    }
+  }
+  else if (af.isRunning())
+  {
+    // Uzytkownik ma pierwszenstwo: powrot na stacje i obsluga enkodera
+    if (det != 0 || pressed) {
+      af.cancel();
+      finishAF();
+      if (pressed) buttonUsed = true;
+      det = 0;
+    } else {
+      serviceAF();
+    }
+  }
+  else if (scanner.isRunning())
+  {
+    // Obrot enkodera lub wcisniecie przycisku przerywa skan
+    if (det != 0 || pressed) {
+      stopScan();
+      if (pressed) buttonUsed = true;  // to wcisniecie nie jest klikiem
+      det = 0;
+    } else {
+      serviceScan();
+    }
+  }
+  else if (seekActive)
+  {
+    // Obrot enkodera lub wcisniecie przycisku przerywa szukanie
+    if (det != 0 || pressed) {
+      stopSeek();
+      if (pressed) buttonUsed = true;  // to wcisniecie nie jest klikiem
+      det = 0;
+    } else {
+      serviceSeek();
+    }
+  }
+  else if (longPress)
+  {
+    startScan();
+  }
+  else if (clicks == 1)
+  {
+    startSeek();
+  }
+  else if (clicks == 2)
+  {
+    toggleSmartTune();
+  }
+  else if (clicks == 3)
+  {
+    startSpectrum();
+  }
+  else if (clicks == 4)
+  {
+    ptySearch();
+  }
 
   if (det != 0)
   {
     if (volModeHeld) setVolume(currentVol + det);
+    else if (smartTune) smartStep(det);
     else             setFrequency(currentFreq + det * FREQ_STEP);
   }
 
+  bool busy = seekActive || scanner.isRunning() || af.isRunning();
+  if (!busy) serviceTune();
+
+  // Podczas cyklu AF dekoder nie dostaje grup z innych czestotliwosci
+  if (!busy && !radio.isTuning() && !tunePending) serviceRDS();
+
   // Auto-zapis po chwili od ostatniej zmiany
   if (settingsDirty && (millis() - lastUserChangeMs > SAVE_DELAY_MS))
   {
@@ -471,12 +1531,43 @@ void loop()
   }
 
   static unsigned long lastUpdate = 0;
-  if (millis() - lastUpdate > 500)
+  if (millis() - lastUpdate > 500 && !radio.isTuning() && !tunePending && !busy)
   {
-    updateFrequency(safeGetChannel());
-    updateSignal();
-    updateStereo();
-    updateVolume();
+    Si4703::Status st = safePollStatus();
+    if (!taActive) refreshStatus(st);
     lastUpdate = millis();
+
+    // W trakcie komunikatu bez przejsc AF
+    if (AF_FOLLOW && !taActive && af.onStatus(currentFreq, st.rssi, rds.getAF())) {
+      LOGI("AF: slaby sygnal (RSSI %d), sprawdzam %u czestotliwosci",
+           st.rssi, rds.getAF()->count);
+    }
+  }
+
+  static unsigned long lastMapSave = 0;
+  if ((bandMap.isDirty() || stationCache.isDirty()) && (millis() - lastMapSave > BANDMAP_SAVE_MS))
+  {
+    if (bandMap.isDirty()) saveBandMap();
+    if (stationCache.isDirty()) saveStationCache();
+    lastMapSave = millis();
+  }
+
+  static unsigned long lastStats = 0;
+  if (millis() - lastStats > STATS_LOG_MS)
+  {
+    LOGI("I2C: cache statusu hit=%lu miss=%lu, zaoszczedzono %lu B zapisu",
+         (unsigned long)radio.getCacheHits(), (unsigned long)radio.getCacheMisses(),
+         (unsigned long)radio.getBytesSaved());
+    LOGI("Strojenie: wyslane=%lu pominiete=%lu",
+         (unsigned long)tunesIssued, (unsigned long)tunesDropped);
+    LOGI("RDS: grupy=%lu utracone=%lu przyjete=%lu odrzucone=%lu",
+         (unsigned long)radio.getRDSGroups(), (unsigned long)radio.getRDSDropped(),
+         (unsigned long)rds.getAccepted(), (unsigned long)rds.getRejected());
+    LOGI("RDS CT: przyjete=%lu odrzucone=%lu, korekty zegara=%lu, sprzeczne z zegarem=%lu",
+         (unsigned long)rds.getCTAccepted(), (unsigned long)rds.getCTRejected(),
+         (unsigned long)clockUpdates, (unsigned long)clockRejected);
+    LOGI("AF: cykle=%lu przejscia=%lu",
+         (unsigned long)af.getChecks(), (unsigned long)af.getSwitches());
+    lastStats = millis();
   }
 }
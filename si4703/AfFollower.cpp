@@ -0,0 +1,218 @@
+/*
+ *  RDS Alternative Frequency following
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#include "Arduino.h"
+#include "AfFollower.h"
+
+AfFollower::AfFollower(Si4703& radio)
+  : _radio(radio)
+{
+  _rssiMin  = 20;
+  _margin   = 6;
+  _weak     = 0;
+  _retryMs  = 0;
+
+  _phase    = PH_IDLE;
+  _origFreq = 0;
+  _origRssi = 0;
+  _pi       = 0;
+  _muteWas  = true;
+  _muted    = false;
+  _muteStartMs = 0;
+  _muteAcc  = 0;
+  _n        = 0;
+  _idx      = 0;
+  _tries    = 0;
+  _tuned    = false;
+  _stepMs   = 0;
+  _pollMs   = 0;
+  _startMs  = 0;
+
+  _switched = false;
+  _freq     = 0;
+  _cycleMs  = 0;
+  _muteMs   = 0;
+  _checks   = 0;
+  _switches = 0;
+}
+
+// -----------------------------------------------------------------------------
+// A cycle starts after WEAK_POLLS weak polls in a row, if the PI has AFs
+// other than the current channel and no failed cycle happened recently.
+// -----------------------------------------------------------------------------
+bool AfFollower::onStatus(int freq, int rssi, const AfList* list)
+{
+  if (isRunning()) return false;
+
+  if (rssi >= _rssiMin) {
+    _weak = 0;
+    return false;
+  }
+  if (++_weak < WEAK_POLLS) return false;
+  if (_retryMs && (long)(millis() - _retryMs) < 0) return false;
+  if (!list) return false;
+
+  _n = 0;
+  for (int i = 0; i < list->count; i++) {
+    int f = list->freq(i);
+    if (f == freq || f < _radio.getBandStart() || f > _radio.getBandEnd()) continue;
+    _code[_n++] = list->code[i];
+  }
+  if (_n == 0) return false;
+
+  _weak     = 0;
+  _origFreq = freq;
+  _origRssi = rssi;
+  _pi       = list->pi;
+  _switched = false;
+  _freq     = freq;
+  _tries    = 0;
+  _checks++;
+
+  _startMs = millis();
+  _muteWas = _radio.getMute();
+  _muteAcc = 0;
+  mute();
+
+  _idx = 0;
+  _radio.beginTune(8750 + _code[0] * 10);
+  _phase = PH_MEASURE;
+  return true;
+}
+
+bool AfFollower::poll(void)
+{
+  uint8_t state;
+
+  switch (_phase)
+  {
+    case PH_MEASURE:
+      state = _radio.pollTune();
+      if (state == TUNE_TUNING) break;
+
+      // RSSI comes with the read that saw STC: no dwell per candidate
+      _rssi[_idx] = (state == TUNE_DONE) ? _radio.getTuneRSSI() : 0;
+
+      if (++_idx < _n) {
+        _radio.beginTune(8750 + _code[_idx] * 10);
+        break;
+      }
+      nextVerify();
+      break;
+
+    case PH_VERIFY:
+      if (!_tuned) {
+        state = _radio.pollTune();
+        if (state == TUNE_TUNING) break;
+        _tuned  = true;
+        _stepMs = millis();
+        _pollMs = _stepMs;
+        unmute();                    // the AF carries the same programme
+      }
+
+      if (millis() - _pollMs < PI_POLL_MS) break;
+      _pollMs = millis();
+
+      if (_radio.readPI() == _pi) {
+        finish(true);
+        break;
+      }
+      if (millis() - _stepMs >= PI_TIMEOUT_MS) {
+        _tries++;
+        nextVerify();
+      }
+      break;
+
+    case PH_RETURN:
+      state = _radio.pollTune();
+      if (state == TUNE_TUNING) break;
+      finish(false);
+      break;
+
+    default:
+      break;
+  }
+
+  return isRunning();
+}
+
+// -----------------------------------------------------------------------------
+// Tune the strongest candidate not tried yet, if it beats the original
+// channel by the margin; otherwise give up and go back.
+// -----------------------------------------------------------------------------
+void AfFollower::nextVerify(void)
+{
+  if (_tries < VERIFY_TRIES) {
+    int best = -1;
+    for (int i = 0; i < _n; i++) {
+      if (_rssi[i] == 0) continue;   // weak, failed or already tried
+      if (best < 0 || _rssi[i] > _rssi[best]) best = i;
+    }
+
+    if (best >= 0 && _rssi[best] >= _origRssi + _margin) {
+      _freq = 8750 + _code[best] * 10;
+      _rssi[best] = 0;
+      _tuned = false;
+      mute();
+      _radio.beginTune(_freq);
+      _phase = PH_VERIFY;
+      return;
+    }
+  }
+  returnHome();
+}
+
+void AfFollower::returnHome(void)
+{
+  _freq = _origFreq;
+  mute();
+  _radio.beginTune(_origFreq);
+  _phase = PH_RETURN;
+}
+
+void AfFollower::cancel(void)
+{
+  if (!isRunning()) return;
+
+  _radio.cancelTune();
+  _freq = _origFreq;
+  mute();
+  _radio.setChannel(_origFreq);
+  finish(false);
+}
+
+void AfFollower::mute(void)
+{
+  if (_muted) return;
+  _radio.setMute(false);             // DMUTE=0: muted
+  _muted = true;
+  _muteStartMs = millis();
+}
+
+void AfFollower::unmute(void)
+{
+  if (!_muted) return;
+  _radio.setMute(_muteWas);
+  _muted = false;
+  _muteAcc += millis() - _muteStartMs;
+}
+
+void AfFollower::finish(bool switched)
+{
+  unmute();
+  _muteMs  = _muteAcc;
+  _cycleMs = millis() - _startMs;
+
+  _switched = switched;
+  if (switched) {
+    _switches++;
+    _retryMs = 0;
+  } else {
+    _retryMs = millis() + RETRY_MS;
+    if (_retryMs == 0) _retryMs = 1;
+  }
+  _phase = PH_IDLE;
+}
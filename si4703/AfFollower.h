@@ -0,0 +1,93 @@
+/*
+ *  RDS Alternative Frequency following
+ *
+ *  Fed with the RSSI of the regular status poll. When the signal stays
+ *  below a threshold, one check cycle runs: every AF of the current PI
+ *  tuned just long enough to read its RSSI (from the STC read), then the
+ *  strongest candidates clearly better than the current channel are
+ *  verified by PI. The first match is kept, otherwise the radio goes back.
+ *  Audio is muted only while the tuner is moving; the candidate plays while
+ *  its PI is awaited. Non-blocking, driven by poll(); cycle time and the
+ *  summed mute time are recorded separately.
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef AfFollower_h
+#define AfFollower_h
+
+#include "Arduino.h"
+#include "Si4703.h"
+#include "AfTable.h"
+
+class AfFollower
+{
+  public:
+    AfFollower(Si4703& radio);
+
+    void  setThreshold(uint8_t rssiMin, uint8_t margin) { _rssiMin = rssiMin; _margin = margin; }
+
+    // Status poll result on freq; starts a check cycle when due (returns true)
+    bool  onStatus(int freq, int rssi, const AfList* list);
+    bool  poll(void);                  // Advance; false once the cycle is over
+    void  cancel(void);                // Abort, back on the original channel
+    bool  isRunning(void) const { return _phase != PH_IDLE; }
+
+    bool     switched(void) const { return _switched; }     // Last cycle moved to an AF
+    int      getFreq(void) const { return _freq; }          // Channel the last cycle ended on
+    uint32_t getLastCycleMs(void) const { return _cycleMs; } // Duration of the last cycle
+    uint32_t getLastMuteMs(void) const { return _muteMs; }   // Audio muted during it
+    uint32_t getChecks(void) const { return _checks; }
+    uint32_t getSwitches(void) const { return _switches; }
+
+  private:
+    static const uint8_t  PH_IDLE    = 0;
+    static const uint8_t  PH_MEASURE = 1;  // tuning candidates for RSSI
+    static const uint8_t  PH_VERIFY  = 2;  // on a candidate, waiting for its PI
+    static const uint8_t  PH_RETURN  = 3;  // tuning back to the original channel
+
+    static const uint8_t  WEAK_POLLS     = 2;     // weak status polls in a row before a check
+    static const uint8_t  VERIFY_TRIES   = 2;     // candidates verified by PI per cycle
+    static const uint16_t PI_POLL_MS     = 30;
+    static const uint16_t PI_TIMEOUT_MS  = 400;   // RDS sync + a few groups
+    static const uint16_t RETRY_MS       = 30000; // after a cycle without a switch
+
+    void  nextVerify(void);
+    void  returnHome(void);
+    void  finish(bool switched);
+    void  mute(void);                  // Tuner about to move: silence
+    void  unmute(void);                // Back to the user's mute state
+
+    Si4703&  _radio;
+    uint8_t  _rssiMin;
+    uint8_t  _margin;
+    uint8_t  _weak;
+    unsigned long _retryMs;
+
+    uint8_t  _phase;
+    int      _origFreq;
+    int      _origRssi;
+    uint16_t _pi;
+    bool     _muteWas;
+    bool     _muted;
+    unsigned long _muteStartMs;
+    uint32_t _muteAcc;                 // muted time of the current cycle
+    uint8_t  _n;
+    uint8_t  _code[AfList::MAX];
+    uint8_t  _rssi[AfList::MAX];
+    uint8_t  _idx;
+    uint8_t  _tries;
+    bool     _tuned;
+    unsigned long _stepMs;
+    unsigned long _pollMs;
+    unsigned long _startMs;
+
+    bool     _switched;
+    int      _freq;
+    uint32_t _cycleMs;
+    uint32_t _muteMs;
+    uint32_t _checks;
+    uint32_t _switches;
+};
+
+#endif
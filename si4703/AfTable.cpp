@@ -0,0 +1,55 @@
+/*
+ *  RDS Alternative Frequency table
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#include <string.h>
+#include "AfTable.h"
+
+AfTable::AfTable()
+{
+  clear();
+}
+
+void AfTable::clear(void)
+{
+  memset(_list, 0, sizeof(_list));
+  _clock = 0;
+}
+
+const AfList* AfTable::find(uint16_t pi) const
+{
+  if (pi == 0) return 0;
+  for (int i = 0; i < AF_TABLE_PIS; i++) {
+    if (_list[i].pi == pi) return &_list[i];
+  }
+  return 0;
+}
+
+void AfTable::add(uint16_t pi, uint8_t code)
+{
+  if (pi == 0 || !isFreqCode(code)) return;
+
+  // Entry of this PI, else a free one, else the least recently updated
+  AfList* e = (AfList*)find(pi);
+  if (!e) {
+    e = &_list[0];
+    for (int i = 0; i < AF_TABLE_PIS; i++) {
+      if (_list[i].pi == 0) {
+        e = &_list[i];
+        break;
+      }
+      if ((uint16_t)(_clock - _list[i].stamp) > (uint16_t)(_clock - e->stamp)) e = &_list[i];
+    }
+    memset(e, 0, sizeof(*e));
+    e->pi = pi;
+  }
+
+  e->stamp = ++_clock;
+
+  for (int i = 0; i < e->count; i++) {
+    if (e->code[i] == code) return;
+  }
+  if (e->count < AfList::MAX) e->code[e->count++] = code;
+}
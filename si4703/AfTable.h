@@ -0,0 +1,50 @@
+/*
+ *  RDS Alternative Frequency table
+ *
+ *  AF codes from group 0A, collected per PI, so a network's other
+ *  transmitters are remembered when moving between stations. A handful of
+ *  PIs are kept; the one not heard from the longest makes room for a new
+ *  one. Codes are stored as sent (1..204 = 87.6..107.9 MHz), which keeps
+ *  a full list at one byte per frequency. No Arduino dependency.
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef AfTable_h
+#define AfTable_h
+
+#include <stdint.h>
+
+#ifndef AF_TABLE_PIS
+  #define AF_TABLE_PIS 4
+#endif
+
+struct AfList
+{
+  static const uint8_t MAX = 25;        // longest list RDS can announce
+
+  uint16_t pi;
+  uint8_t  count;
+  uint8_t  code[MAX];
+  uint16_t stamp;                       // last update (table clock)
+
+  int freq(uint8_t i) const { return 8750 + code[i] * 10; } // 10kHz units
+};
+
+class AfTable
+{
+  public:
+    AfTable();
+
+    void  clear(void);
+    void  add(uint16_t pi, uint8_t code);      // Code 1..204 heard for pi
+    const AfList* find(uint16_t pi) const;     // List of pi, or 0
+
+    static bool isFreqCode(uint8_t code) { return code >= 1 && code <= 204; }
+
+  private:
+    AfList   _list[AF_TABLE_PIS];
+    uint16_t _clock;
+};
+
+#endif
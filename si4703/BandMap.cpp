@@ -0,0 +1,102 @@
+/*
+ *  Per-channel band map
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#include "Arduino.h"
+#include "BandMap.h"
+
+BandMap::BandMap()
+{
+  _bandStart = 8750;
+  _bandEnd   = 10800;
+  _bandSpace = 10;
+  _goodRssi  = 25;
+  _clockBase = 0;
+  clear();
+}
+
+void BandMap::begin(int bandStart, int bandEnd, int bandSpace)
+{
+  _bandStart = bandStart;
+  _bandEnd   = bandEnd;
+  _bandSpace = bandSpace > 0 ? bandSpace : 10;
+}
+
+void BandMap::clear(void)
+{
+  memset(_ch, 0, sizeof(_ch));
+  _dirty = true;
+}
+
+int BandMap::index(int freq) const
+{
+  if (freq < _bandStart || freq > _bandEnd) return -1;
+
+  int i = (freq - _bandStart) / _bandSpace;
+  if (i >= BANDMAP_CHANNELS) return -1;
+  return i;
+}
+
+uint16_t BandMap::now(void) const
+{
+  uint32_t h = _clockBase + millis() / 3600000UL;
+  if (h == 0)     return 1;      // 0 is reserved for "never seen"
+  if (h > 0xFFFF) return 0xFFFF;
+  return (uint16_t)h;
+}
+
+void BandMap::update(int freq, int rssi, bool stereo)
+{
+  int i = index(freq);
+  if (i < 0) return;
+
+  if (rssi < 0)        rssi = 0;
+  if (rssi > RSSI_MAX) rssi = RSSI_MAX;
+
+  // update() runs on every status refresh: RSSI jitter of a dB or two must
+  // not make the map dirty, or it would be rewritten to flash forever
+  BandMapEntry& e = _ch[i];
+  uint16_t t      = now();             // never 0: a first visit always counts
+  int      old    = e.rssiSt & RSSI_MAX;
+  bool     oldSt  = (e.rssiSt & ST_BIT) != 0;
+
+  if (e.seen == t && oldSt == stereo && abs(rssi - old) < RSSI_HYST &&
+      (old >= _goodRssi) == (rssi >= _goodRssi)) return;
+
+  e.rssiSt = (uint8_t)rssi | (stereo ? ST_BIT : 0);
+  e.seen   = t;
+  _dirty   = true;
+}
+
+void BandMap::setPI(int freq, uint16_t pi)
+{
+  int i = index(freq);
+  if (i < 0 || pi == 0 || _ch[i].pi == pi) return;
+
+  _ch[i].pi = pi;
+  _dirty = true;
+}
+
+const BandMapEntry* BandMap::get(int freq) const
+{
+  int i = index(freq);
+  return i < 0 ? 0 : &_ch[i];
+}
+
+bool BandMap::isGood(int freq) const
+{
+  const BandMapEntry* e = get(freq);
+  return e && e->seen != 0 && (e->rssiSt & RSSI_MAX) >= _goodRssi;
+}
+
+int BandMap::nextGood(int freq, int dir) const
+{
+  int step = dir > 0 ? _bandSpace : -_bandSpace;
+
+  for (int f = freq + step; f >= _bandStart && f <= _bandEnd; f += step) {
+    if (isGood(f)) return f;
+  }
+  return -1;
+}
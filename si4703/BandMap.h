@@ -0,0 +1,75 @@
+/*
+ *  Per-channel band map
+ *
+ *  One compact record per channel (RSSI, stereo, RDS PI, last-seen time),
+ *  filled opportunistically whenever the radio lands on a channel and by
+ *  scans. Used to jump straight to known-good channels instead of tuning
+ *  through every dead 100 kHz step. Static memory, persisted as one blob.
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef BandMap_h
+#define BandMap_h
+
+#include "Arduino.h"
+
+// 87.5–108 MHz at 100 kHz = 206 channels
+#ifndef BANDMAP_CHANNELS
+  #define BANDMAP_CHANNELS 206
+#endif
+
+// One channel record, 6 bytes
+struct BandMapEntry
+{
+  uint16_t pi;      // RDS Programme Identification (0 = unknown)
+  uint16_t seen;    // Last seen, BandMap clock hours (0 = never)
+  uint8_t  rssiSt;  // bit 7: stereo, bits 0..6: RSSI
+  uint8_t  flags;   // reserved
+};
+
+class BandMap
+{
+  public:
+    static const uint8_t ST_BIT   = 0x80;
+    static const uint8_t RSSI_MAX = 0x7F;
+    static const uint8_t RSSI_HYST = 4;             // smaller RSSI changes are not recorded
+
+    BandMap();
+
+    void  begin(int bandStart, int bandEnd, int bandSpace); // Band geometry (clears nothing)
+    void  clear(void);
+
+    void  update(int freq, int rssi, bool stereo);  // Radio landed on freq (or is still there)
+    void  setPI(int freq, uint16_t pi);             // RDS PI confirmed on freq
+
+    const BandMapEntry* get(int freq) const;        // Record of freq, or 0 if outside the map
+    bool  isGood(int freq) const;                   // Seen with RSSI >= good threshold
+    int   nextGood(int freq, int dir) const;        // Next known-good channel up/down, or -1
+    void  setGoodRssi(uint8_t rssi) { _goodRssi = rssi; }
+
+    // Map clock (hours) continues across reboots via the persisted base
+    uint16_t now(void) const;
+    void  setClockBase(uint16_t hours) { _clockBase = hours; }
+
+    bool  isDirty(void) const { return _dirty; }
+    void  clearDirty(void) { _dirty = false; }
+
+    // Raw access for persistence (load straight into raw(), then clearDirty())
+    const BandMapEntry* data(void) const { return _ch; }
+    BandMapEntry*       raw(void) { return _ch; }
+    size_t size(void) const { return sizeof(_ch); }
+
+  private:
+    int   index(int freq) const;                    // Channel index, or -1
+
+    BandMapEntry _ch[BANDMAP_CHANNELS];
+    int      _bandStart;
+    int      _bandEnd;
+    int      _bandSpace;
+    uint8_t  _goodRssi;
+    uint16_t _clockBase;
+    bool     _dirty;
+};
+
+#endif
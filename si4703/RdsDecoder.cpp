@@ -0,0 +1,335 @@
+/*
+ *  RDS decoder: PI, PTY, TP/TA and the Programme Service name
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#include <string.h>
+#include "RdsDecoder.h"
+
+// Block B layout (all groups)
+static const uint8_t  GROUP_SHIFT   = 12;        // group type 0..15
+static const uint16_t VERSION_B     = 0x0800;    // B0: 0 = version A, 1 = version B
+static const uint16_t TP_BIT        = 0x0400;
+static const uint8_t  PTY_SHIFT     = 5;
+static const uint16_t PTY_MASK      = 0x1F;
+
+// Block B layout, group 0
+static const uint16_t TA_BIT        = 0x0010;
+static const uint16_t SEGMENT_MASK  = 0x0003;
+
+// Group 0A block C: AF codes
+static const uint8_t  AF_LFMF       = 250;       // an LF/MF frequency follows: not usable here
+
+// Block B layout, group 2
+static const uint16_t TEXT_AB_BIT   = 0x0010;
+static const uint16_t RT_SEG_MASK   = 0x000F;
+static const uint8_t  RT_SEG_COUNT  = 16;        // 16 segments: 4 chars (2A) or 2 chars (2B)
+static const char     RT_END        = 0x0D;      // end of a text shorter than the maximum
+
+// Group 4A: clock time
+static const uint32_t MJD_UNIX_EPOCH = 40587;    // MJD of 1970-01-01
+static const uint32_t MJD_MIN        = 58849;    // 2020-01-01: older dates are garbage
+static const uint32_t MJD_MAX        = 80000;    // ~2078
+static const uint8_t  CT_OFFSET_MAX  = 28;       // +/-14 h in half hours
+
+// Block indexes within RdsGroup
+static const uint8_t  BLK_A = 0;
+static const uint8_t  BLK_B = 1;
+static const uint8_t  BLK_C = 2;
+static const uint8_t  BLK_D = 3;
+
+RdsDecoder::RdsDecoder()
+{
+  _groups    = 0;
+  _accepted  = 0;
+  _psVersion = 0;
+  _rtVersion = 0;
+
+  _ctUtc      = 0;
+  _ctOffset   = 0;
+  _ctMs       = 0;
+  _ctVersion  = 0;
+  _ctAccepted = 0;
+  _ctRejected = 0;
+
+  _policy.mode = RDS_ACCEPT_BLOCK;
+  for (int i = 0; i < 4; i++) _policy.maxLevel[i] = RDS_BLER_NONE;
+
+  reset();
+}
+
+void RdsDecoder::reset(void)
+{
+  _pi     = 0;
+  _piCand = 0;
+  _pty    = 0;
+  _tp     = false;
+  _ta     = false;
+  _taLast = false;
+
+  memset(_ps, ' ', PS_LEN);
+  _ps[PS_LEN] = 0;
+  _psMask = 0;
+  _psVersion++;
+  memset(_psVotes, 0, sizeof(_psVotes));
+  memset(_psVoteCount, 0, sizeof(_psVoteCount));
+
+  clearRTBuild();
+  _rtAB = -1;
+  _rt[0] = 0;
+  _rtVersion++;
+}
+
+bool RdsDecoder::usable(const RdsGroup& g, uint8_t blk) const
+{
+  uint8_t level = g.errors(blk);
+  return level < RDS_BLER_BAD && level <= _policy.maxLevel[blk];
+}
+
+void RdsDecoder::feed(const RdsGroup& g)
+{
+  _groups++;
+
+  if (_policy.mode == RDS_DROP_GROUP) {
+    for (uint8_t i = BLK_A; i <= BLK_D; i++) {
+      if (!usable(g, i)) return;
+    }
+  }
+
+  // Without block B the group type is unknown
+  if (!usable(g, BLK_B)) return;
+
+  uint16_t b = g.block[BLK_B];
+
+  // PI comes in block A, and again in block C of version B groups
+  // (a PI is only taken once repeated, which already votes out bad blocks)
+  if (usable(g, BLK_A))                         decodePI(g.block[BLK_A]);
+  else if ((b & VERSION_B) && usable(g, BLK_C)) decodePI(g.block[BLK_C]);
+
+  if (_pi == 0) return;
+  _accepted++;
+
+  _tp  = (b & TP_BIT) != 0;
+  _pty = (b >> PTY_SHIFT) & PTY_MASK;
+
+  switch (b >> GROUP_SHIFT)
+  {
+    case 0: decodeGroup0(g); break;
+    case 2: decodeGroup2(g); break;
+    case 4: if (!(b & VERSION_B)) decodeGroup4A(g); break;
+    default: break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// PI is taken once it has been received twice in a row; a different PI
+// confirmed the same way means another station, so everything is reset.
+// -----------------------------------------------------------------------------
+void RdsDecoder::decodePI(uint16_t pi)
+{
+  if (pi == _pi) {
+    _piCand = 0;
+    return;
+  }
+  if (pi != _piCand) {
+    _piCand = pi;
+    return;
+  }
+
+  if (_pi != 0) reset();
+  _pi = pi;
+  _piCand = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Group 0A/0B: basic tuning and switching information. Block D carries
+// two characters of the PS name at the segment given in block B.
+// -----------------------------------------------------------------------------
+void RdsDecoder::decodeGroup0(const RdsGroup& g)
+{
+  uint16_t b = g.block[BLK_B];
+
+  // TA switches the receiver's volume and screen: require two groups alike
+  bool ta = (b & TA_BIT) != 0;
+  if (ta == _taLast) _ta = ta;
+  _taLast = ta;
+
+  // 0A: two AF codes in block C (0B repeats the PI there instead)
+  if (!(b & VERSION_B) && usable(g, BLK_C)) {
+    uint8_t af1 = g.block[BLK_C] >> 8;
+    uint8_t af2 = g.block[BLK_C] & 0xFF;
+    if (af1 != AF_LFMF) {
+      _af.add(_pi, af1);
+      _af.add(_pi, af2);
+    }
+  }
+
+  if (!usable(g, BLK_D)) return;
+  votePS(b & SEGMENT_MASK, g.block[BLK_D]);
+}
+
+void RdsDecoder::votePS(uint8_t seg, uint16_t pair)
+{
+  uint16_t* v = _psVotes[seg];
+
+  // Keep the last VOTES receptions of this segment, newest first
+  for (int i = VOTES - 1; i > 0; i--) v[i] = v[i - 1];
+  v[0] = pair;
+  if (_psVoteCount[seg] < VOTES) _psVoteCount[seg]++;
+
+  // The newest reception wins once it matches one of the two before it
+  int agree = 0;
+  for (int i = 1; i < _psVoteCount[seg]; i++) {
+    if (v[i] == pair) agree++;
+  }
+  if (agree == 0) return;
+
+  char hi = (char)(pair >> 8);
+  char lo = (char)(pair & 0xFF);
+  char* p = &_ps[seg * 2];
+
+  if (p[0] != hi || p[1] != lo || !(_psMask & (1 << seg))) {
+    p[0] = hi;
+    p[1] = lo;
+    _psMask |= (1 << seg);
+    _psVersion++;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Group 2A/2B: RadioText. 2A carries 4 characters in blocks C and D (up to
+// 64), 2B carries 2 in block D (up to 32). A 0x0D marks an early end.
+// -----------------------------------------------------------------------------
+void RdsDecoder::decodeGroup2(const RdsGroup& g)
+{
+  uint16_t b  = g.block[BLK_B];
+  bool     vB = (b & VERSION_B) != 0;
+  int8_t   ab = (b & TEXT_AB_BIT) ? 1 : 0;
+
+  if (!usable(g, BLK_D)) return;
+  if (!vB && !usable(g, BLK_C)) return;
+
+  // A/B flip: the station started a new message
+  if (ab != _rtAB) {
+    clearRTBuild();
+    _rtAB = ab;
+  }
+
+  uint8_t  seg   = b & RT_SEG_MASK;
+  uint8_t  width = vB ? 2 : 4;
+  uint8_t  pos   = seg * width;
+  uint16_t bit   = 1 << seg;
+
+  char c[4];
+  uint8_t n = 0;
+  if (!vB) {
+    c[n++] = (char)(g.block[BLK_C] >> 8);
+    c[n++] = (char)(g.block[BLK_C] & 0xFF);
+  }
+  c[n++] = (char)(g.block[BLK_D] >> 8);
+  c[n++] = (char)(g.block[BLK_D] & 0xFF);
+
+  // Voting: a segment with corrected errors counts once it arrives twice
+  // alike, and never overrides a segment already received
+  bool clean = g.errors(BLK_D) == 0 && (vB || g.errors(BLK_C) == 0);
+  if (_policy.mode == RDS_ACCEPT_VOTE && !clean) {
+    bool same = (pos + n <= RT_LEN) && memcmp(&_rtBuild[pos], c, n) == 0;
+    if (_rtMask & bit) {
+      if (!same) return;
+    } else if (!(same && (_rtTentative & bit))) {
+      for (uint8_t i = 0; i < n; i++) putRT(pos + i, c[i]);
+      _rtTentative |= bit;
+      return;
+    }
+  }
+
+  for (uint8_t i = 0; i < n; i++) putRT(pos + i, c[i]);
+  _rtTentative &= ~bit;
+  _rtMask |= bit;
+
+  // A terminator in this segment fixes the message length
+  for (uint8_t i = seg * width; i < seg * width + width; i++) {
+    if (_rtBuild[i] == RT_END) {
+      _rtSegments = seg + 1;
+      break;
+    }
+  }
+
+  uint16_t need = (_rtSegments >= RT_SEG_COUNT) ? 0xFFFF : (uint16_t)((1 << _rtSegments) - 1);
+  if ((_rtMask & need) == need) publishRT();
+}
+
+void RdsDecoder::putRT(uint8_t pos, char c)
+{
+  if (pos < RT_LEN) _rtBuild[pos] = c;
+}
+
+void RdsDecoder::clearRTBuild(void)
+{
+  memset(_rtBuild, ' ', RT_LEN);
+  _rtBuild[RT_LEN] = 0;
+  _rtMask     = 0;
+  _rtTentative = 0;
+  _rtSegments = RT_SEG_COUNT;
+}
+
+// -----------------------------------------------------------------------------
+// Copy the complete message up to the terminator, without trailing spaces.
+// The build buffer keeps its segments: a repeat of the same message only
+// refreshes them.
+// -----------------------------------------------------------------------------
+void RdsDecoder::publishRT(void)
+{
+  char    text[RT_LEN + 1];
+  uint8_t len = 0;
+
+  while (len < RT_LEN && _rtBuild[len] != RT_END) {
+    text[len] = _rtBuild[len];
+    len++;
+  }
+  while (len > 0 && text[len - 1] == ' ') len--;
+  text[len] = 0;
+
+  if (strcmp(text, _rt) == 0) return;
+  memcpy(_rt, text, len + 1);
+  _rtVersion++;
+}
+
+// -----------------------------------------------------------------------------
+// Group 4A: clock time, sent at the start of each minute.
+//   B bits 1..0 + C bits 15..1: Modified Julian Day (17 bits)
+//   C bit 0 + D bits 15..12:    hour (UTC)
+//   D bits 11..6:               minute
+//   D bit 5 / bits 4..0:        local offset sign / half hours
+// A wrong time is worse than none: any uncorrectable block, or a field out
+// of range, rejects the whole group.
+// -----------------------------------------------------------------------------
+void RdsDecoder::decodeGroup4A(const RdsGroup& g)
+{
+  uint16_t b = g.block[BLK_B];
+  uint16_t c = g.block[BLK_C];
+  uint16_t d = g.block[BLK_D];
+
+  if (g.errors(BLK_C) >= RDS_BLER_BAD || g.errors(BLK_D) >= RDS_BLER_BAD ||
+      !usable(g, BLK_C) || !usable(g, BLK_D)) {
+    _ctRejected++;
+    return;
+  }
+
+  uint32_t mjd    = ((uint32_t)(b & 0x03) << 15) | (c >> 1);
+  uint8_t  hour   = ((c & 0x01) << 4) | (d >> 12);
+  uint8_t  minute = (d >> 6) & 0x3F;
+  uint8_t  offset = d & 0x1F;
+
+  if (mjd < MJD_MIN || mjd > MJD_MAX || hour > 23 || minute > 59 || offset > CT_OFFSET_MAX) {
+    _ctRejected++;
+    return;
+  }
+
+  _ctUtc    = (mjd - MJD_UNIX_EPOCH) * 86400UL + hour * 3600UL + minute * 60UL;
+  _ctOffset = (d & 0x20) ? -(int8_t)offset : (int8_t)offset;
+  _ctMs     = g.ms;
+  _ctAccepted++;
+  if (++_ctVersion == 0) _ctVersion = 1;  // 0 means "no CT yet"
+}
@@ -0,0 +1,144 @@
+/*
+ *  RDS decoder: PI, PTY, TP/TA and the Programme Service name
+ *
+ *  Fed one captured RdsGroup at a time. Pure state machine with no heap,
+ *  no I/O and no Arduino dependency, so the same code runs on the radio and
+ *  on a Linux host (replays, throughput measurements).
+ *
+ *  The PS name arrives as four 2-character segments in groups 0A/0B. A
+ *  segment is only taken into the name once 2 of its last 3 receptions
+ *  agree, which keeps single corrupted groups off the display.
+ *
+ *  RadioText (groups 2A/2B) is assembled in one buffer and published to a
+ *  second one only when complete, so readers always see a whole message.
+ *  A flip of the text A/B flag starts a new message.
+ *
+ *  Alternative Frequencies (group 0A block C, methods A and B alike: every
+ *  frequency code is a candidate, PI is verified before any switch) go to
+ *  a per-PI table that outlives station changes.
+ *
+ *  Clock-time groups (4A) give UTC with minute resolution plus the local
+ *  offset; they are only taken from groups with no uncorrectable block and
+ *  a plausible date.
+ *
+ *  Which blocks are used depends on their error level (BLERA..BLERD) and
+ *  on the acceptance policy, see RdsPolicy.
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef RdsDecoder_h
+#define RdsDecoder_h
+
+#include <stdint.h>
+#include "RdsGroup.h"
+#include "AfTable.h"
+
+// Acceptance modes
+static const uint8_t 	RDS_DROP_GROUP	= 0;	// Any block above its max level drops the whole group
+static const uint8_t 	RDS_ACCEPT_BLOCK	= 1;	// Each block judged on its own; bad blocks are skipped
+static const uint8_t 	RDS_ACCEPT_VOTE	= 2;	// As ACCEPT_BLOCK, but corrected RT blocks must repeat first
+
+// Block error levels as reported by the Si4703 (BLERA..BLERD)
+static const uint8_t 	RDS_BLER_NONE	= 0;	// no errors
+static const uint8_t 	RDS_BLER_1_2	= 1;	// 1-2 errors corrected
+static const uint8_t 	RDS_BLER_3_5	= 2;	// 3-5 errors corrected
+static const uint8_t 	RDS_BLER_BAD	= 3;	// 6+ errors or uncorrectable: never used
+
+struct RdsPolicy
+{
+  uint8_t mode;           // RDS_DROP_GROUP / RDS_ACCEPT_BLOCK / RDS_ACCEPT_VOTE
+  uint8_t maxLevel[4];    // Highest error level used, per block A..D
+};
+
+class RdsDecoder
+{
+  public:
+    static const uint8_t PS_LEN      = 8;
+    static const uint8_t PS_SEGMENTS = 4;
+    static const uint8_t RT_LEN      = 64;
+
+    RdsDecoder();
+
+    void  reset(void);                  // New station: forget everything
+    void  feed(const RdsGroup& g);      // Decode one group
+    void  setPolicy(const RdsPolicy& p) { _policy = p; } // Default: ACCEPT_BLOCK, error-free blocks only
+
+    uint16_t getPI(void) const { return _pi; }     // 0 = not known yet
+    uint8_t  getPTY(void) const { return _pty; }
+    bool     getTP(void) const { return _tp; }
+    bool     getTA(void) const { return _ta; }     // Changes after two groups alike
+
+    const char* getPS(void) const { return _ps; }  // 8 chars, NUL-terminated (spaces where unconfirmed)
+    bool     hasPS(void) const { return _psMask == (1 << PS_SEGMENTS) - 1; } // All segments confirmed
+    uint16_t getPSVersion(void) const { return _psVersion; } // Bumps on every change of getPS()
+
+    const char* getRT(void) const { return _rt; }  // Last complete RadioText ("" = none), trailing spaces trimmed
+    uint16_t getRTVersion(void) const { return _rtVersion; } // Bumps on every change of getRT()
+
+    const AfList*  getAF(void) const { return _af.find(_pi); }  // AFs of the current PI, or 0
+    const AfTable& getAFTable(void) const { return _af; }
+
+    // Clock time (group 4A). UTC as Unix seconds, valid at the capture time getCTMs()
+    bool     hasCT(void) const { return _ctVersion != 0; }
+    uint32_t getCTUtc(void) const { return _ctUtc; }
+    int8_t   getCTOffset(void) const { return _ctOffset; }    // Local offset, half hours
+    uint32_t getCTMs(void) const { return _ctMs; }            // RdsGroup::ms of the CT group
+    uint16_t getCTVersion(void) const { return _ctVersion; }  // Bumps on every accepted CT
+    uint32_t getCTAccepted(void) const { return _ctAccepted; }
+    uint32_t getCTRejected(void) const { return _ctRejected; }
+
+    uint32_t getGroups(void) const { return _groups; }     // Groups fed
+    uint32_t getAccepted(void) const { return _accepted; } // Groups used (valid PI and type)
+    uint32_t getRejected(void) const { return _groups - _accepted; }
+
+  private:
+    static const uint8_t VOTES = 3;
+
+    bool  usable(const RdsGroup& g, uint8_t blk) const; // Error level within the policy
+    void  decodePI(uint16_t pi);
+    void  decodeGroup0(const RdsGroup& g);
+    void  votePS(uint8_t seg, uint16_t pair);
+    void  decodeGroup2(const RdsGroup& g);
+    void  decodeGroup4A(const RdsGroup& g);
+    void  putRT(uint8_t pos, char c);
+    void  clearRTBuild(void);
+    void  publishRT(void);
+
+    uint16_t _pi;
+    uint16_t _piCand;                   // PI seen once, waiting for a repeat
+    uint8_t  _pty;
+    bool     _tp;
+    bool     _ta;
+    bool     _taLast;                   // TA of the previous group 0
+
+    char     _ps[PS_LEN + 1];
+    uint8_t  _psMask;                   // bit n: segment n confirmed
+    uint16_t _psVersion;
+    uint16_t _psVotes[PS_SEGMENTS][VOTES]; // last receptions of each segment (char pair)
+    uint8_t  _psVoteCount[PS_SEGMENTS];
+
+    // RadioText: _rtBuild is being received, _rt is the last complete message
+    char     _rtBuild[RT_LEN + 1];
+    char     _rt[RT_LEN + 1];
+    uint16_t _rtMask;                   // bit n: segment n received
+    uint16_t _rtTentative;              // bit n: segment n seen once with corrected errors
+    uint8_t  _rtSegments;               // segments up to the 0x0D terminator (or all)
+    int8_t   _rtAB;                     // text A/B flag of _rtBuild (-1 = none yet)
+    uint16_t _rtVersion;
+
+    // Kept across reset(): AFs are per PI, clock time is not per station
+    AfTable  _af;
+    uint32_t _ctUtc;
+    int8_t   _ctOffset;
+    uint32_t _ctMs;
+    uint16_t _ctVersion;
+    uint32_t _ctAccepted;
+    uint32_t _ctRejected;
+
+    RdsPolicy _policy;
+    uint32_t _groups;
+    uint32_t _accepted;
+};
+
+#endif
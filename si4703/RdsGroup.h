@@ -0,0 +1,86 @@
+/*
+ *  RDS group record and single-producer/single-consumer ring buffer
+ *
+ *  A group is the four 16-bit blocks A..D exactly as the Si4703 delivered
+ *  them, the per-block error levels (BLERA..BLERD, 0 = none .. 3 = too many
+ *  errors) packed two bits each, and the capture time. The ring has a fixed
+ *  power-of-two capacity and no locks: one side only pushes, the other only
+ *  pops, and the indices are published with acquire/release ordering so the
+ *  producer may later run in a task or ISR context. Depends only on
+ *  <stdint.h>, so it builds unchanged on a Linux host.
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef RdsGroup_h
+#define RdsGroup_h
+
+#include <stdint.h>
+
+#ifndef RDS_RING_SIZE
+  #define RDS_RING_SIZE 16        // groups (~1.4 s of RDS at 11.4 groups/s), power of two
+#endif
+
+struct RdsGroup
+{
+  uint16_t block[4];              // A, B, C, D
+  uint8_t  bler;                  // bits 1..0: A, 3..2: B, 5..4: C, 7..6: D
+  uint32_t ms;                    // millis() at capture
+
+  uint8_t errors(uint8_t blk) const { return (bler >> (blk * 2)) & 0x03; }
+
+  static uint8_t packBler(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+  {
+    return (a & 0x03) | ((b & 0x03) << 2) | ((c & 0x03) << 4) | ((d & 0x03) << 6);
+  }
+};
+
+class RdsRing
+{
+  public:
+    static const uint8_t CAPACITY = RDS_RING_SIZE;
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "RDS_RING_SIZE must be a power of two");
+
+    RdsRing() : _head(0), _tail(0), _dropped(0) {}
+
+    // Producer side. A full ring drops the new group (the reader is behind).
+    bool push(const RdsGroup& g)
+    {
+      uint8_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+      uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+
+      if ((uint8_t)(head - tail) >= CAPACITY) {
+        _dropped++;
+        return false;
+      }
+      _buf[head & (CAPACITY - 1)] = g;
+      __atomic_store_n(&_head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+      return true;
+    }
+
+    // Consumer side
+    bool pop(RdsGroup& g)
+    {
+      uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+      uint8_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+
+      if (head == tail) return false;
+      g = _buf[tail & (CAPACITY - 1)];
+      __atomic_store_n(&_tail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);
+      return true;
+    }
+
+    uint8_t  count(void) const
+    {
+      return (uint8_t)(__atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE));
+    }
+    uint32_t getDropped(void) const { return _dropped; }   // written by the producer only
+
+  private:
+    RdsGroup _buf[CAPACITY];
+    uint8_t  _head;               // next slot to write (producer)
+    uint8_t  _tail;               // next slot to read (consumer)
+    uint32_t _dropped;
+};
+
+#endif
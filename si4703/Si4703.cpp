@@ -15,6 +15,8 @@
 #include "Si4703.h"
 #include "Wire.h"
 
+namespace R = Si4703Reg;
+
 // -----------------------------------------------------------------------------
 // Si4703 Class Initialization
 // NOTE: Default arguments must exist ONLY in the header (.h), not here.
@@ -56,32 +58,159 @@ Si4703::Si4703(
   _skcnt  = skcnt;
   _sksnr  = sksnr;
   _agcd   = agcd;
+
+  // Write-back tracking
+  _writtenValid = false;
+  _ctrlCached   = false;
+  _bytesSaved   = 0;
+  _transactions = 0;
+
+  // Transactions
+  _txDepth      = 0;
+  _txTune       = false;
+
+  // Tune state machine
+  _tuning       = false;
+  _stcPending   = false;
+  _stcWait      = false;
+  _tuneCmd      = R::TUNE(0).write();
+  _tuneStartMs  = 0;
+  _tunePollMs   = 0;
+  _tuneStatus   = 0;
+
+  _seeking      = false;
+
+  // GPIO2 interrupt
+  _intMode      = false;
+  _intSeen      = false;
+  _stcEdge      = false;
+
+  // Status read cache (all fields read fresh until configured)
+  _shadowMs     = 0;
+  _shadowWords  = 0;
+  _cacheHits    = 0;
+  _cacheMisses  = 0;
+  for (int i = 0; i < FIELD_COUNT; i++) _maxAge[i] = 0;
+
+  // RDS capture
+  _rdsGroups    = 0;
+  _rdsIntMode   = false;
+  memset(&_rdsLast, 0, sizeof(_rdsLast));
+#if SI4703_RDS_TASK
+  _rdsTask      = 0;
+  _readLock     = 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Read the first N registers (in read order) to Shadow
+// Reading order: 0A..0F, 00..09 = up to 16 words = 32 bytes
+// The chip always starts reading at 0x0A, so a status-only query needs just
+// the first word(s); words beyond N keep their previous shadow contents.
+// -----------------------------------------------------------------------------
+void Si4703::getShadow(uint8_t words)
+{
+  if (words > SHADOW_WORDS) words = SHADOW_WORDS;
+
+  readLock();
+  Wire.requestFrom(I2C_ADDR, words * 2);
+  countTransaction();
+  for (int i = 0; i < words; i++) {
+    uint16_t w = (Wire.read() << 8) | Wire.read();
+
+    // Once started, the MCU-written control registers are authoritative
+    if (_ctrlCached && i >= CTRL_FIRST && i < CTRL_FIRST + CTRL_COUNT) continue;
+    shadow[i] = w;
+  }
+
+  _shadowMs    = millis();
+  _shadowWords = words;
+
+  // The blocks came with this read anyway: no extra transaction for RDS.
+  // Once the interrupt task has run, it is the ring's only producer.
+  if (words >= RDS_WORDS && !(_rdsIntMode && _intSeen)) captureRDS(shadow, _shadowMs);
+  readUnlock();
+}
+
+// -----------------------------------------------------------------------------
+// Read status words unless the last read covering them is younger than the
+// field's max age. STC defaults to 0 so tune/seek completion is always live.
+// -----------------------------------------------------------------------------
+void Si4703::readStatus(uint8_t words, uint8_t field)
+{
+  uint16_t maxAge = _maxAge[field];
+
+  if (maxAge > 0 && _shadowWords >= words && (millis() - _shadowMs) < maxAge) {
+    _cacheHits++;
+    return;
+  }
+
+  _cacheMisses++;
+  getShadow(words);
+}
+
+// -----------------------------------------------------------------------------
+// Make sure control registers (0x02..0x07) in Shadow are current.
+// After start() they are served from the cache with no I2C traffic.
+// -----------------------------------------------------------------------------
+void Si4703::syncControl()
+{
+  if (!_ctrlCached) getShadow(CONTROL_WORDS);
 }
 
 // -----------------------------------------------------------------------------
-// Read the entire register set (0x00 - 0x0F) to Shadow
-// Reading order: 0A..0F, 00..09 = 16 words = 32 bytes
+// Re-read the entire register set and adopt the device control registers
+// as the cached copy (use when coherency is in doubt, e.g. after a reset)
 // -----------------------------------------------------------------------------
-void Si4703::getShadow()
+void Si4703::resync()
 {
-  Wire.requestFrom(I2C_ADDR, 32);
-  for (int i = 0; i < 16; i++) {
-    shadow.word[i] = (Wire.read() << 8) | Wire.read();
+  _ctrlCached = false;
+  getShadow(SHADOW_WORDS);
+
+  for (int i = 0; i < CTRL_COUNT; i++) {
+    _written[i] = shadow[CTRL_FIRST + i];
   }
+  _writtenValid = true;
+  _ctrlCached   = true;
 }
 
 // -----------------------------------------------------------------------------
-// Write the current 6 control registers (0x02 to 0x07) to the Si4703
+// Write the control registers (0x02 to 0x07) to the Si4703
 // (library uses i=8..13 -> reg 0x02..0x07)
+// Writes always start at 0x02 and must be contiguous, so only 0x02 up to the
+// highest register changed since the last successful write is sent.
 // -----------------------------------------------------------------------------
 byte Si4703::putShadow()
 {
+  int last = CTRL_FIRST + CTRL_COUNT - 1;
+
+  if (_writtenValid) {
+    while (last >= CTRL_FIRST && shadow[last] == _written[last - CTRL_FIRST]) {
+      last--;
+    }
+  }
+
+  _bytesSaved += 2 * (CTRL_FIRST + CTRL_COUNT - 1 - last);
+  if (last < CTRL_FIRST) return 0; // nothing changed
+
   Wire.beginTransmission(I2C_ADDR);
-  for (int i = 8; i < 14; i++) {
-    Wire.write(shadow.word[i] >> 8);
-    Wire.write(shadow.word[i] & 0x00FF);
+  for (int i = CTRL_FIRST; i <= last; i++) {
+    Wire.write(shadow[i] >> 8);
+    Wire.write(shadow[i] & 0x00FF);
   }
-  return Wire.endTransmission();
+  byte err = Wire.endTransmission();
+  countTransaction();
+
+  // Device state changes with any write: cached status is no longer valid
+  _shadowWords = 0;
+
+  if (err == 0) {
+    for (int i = CTRL_FIRST; i <= last; i++) {
+      _written[i - CTRL_FIRST] = shadow[i];
+    }
+    _writtenValid = true; // first write after reset is always a full one
+  }
+  return err;
 }
 
 // -----------------------------------------------------------------------------
@@ -99,6 +228,10 @@ void Si4703::bus3Wire(void)
 // -----------------------------------------------------------------------------
 void Si4703::bus2Wire(void)
 {
+  // Device is reset below; nothing is known about its control registers
+  _writtenValid = false;
+  _ctrlCached   = false;
+
   pinMode(_rstPin, OUTPUT);
   pinMode(_sdioPin, OUTPUT);
 
@@ -129,16 +262,14 @@ void Si4703::bus2Wire(void)
 void Si4703::powerUp()
 {
   // Enable Oscillator
-  getShadow();
-  shadow.reg.TEST1.bits.XOSCEN = 1;
+  syncControl();
+  setField(R::XOSCEN, 1);
   putShadow();
   delay(500);
 
   // Enable Device
-  getShadow();
-  shadow.reg.POWERCFG.bits.ENABLE  = 1;
-  shadow.reg.POWERCFG.bits.DISABLE = 0;
-  shadow.reg.POWERCFG.bits.DMUTE   = 1; // 1 = unmute (device default semantics)
+  syncControl();
+  apply(R::ENABLE(1) | R::DISABLE(0) | R::DMUTE(1)); // DMUTE 1 = unmute (device default semantics)
   putShadow();
   delay(110);
 }
@@ -148,16 +279,12 @@ void Si4703::powerUp()
 // -----------------------------------------------------------------------------
 void Si4703::powerDown()
 {
-  getShadow();
-  shadow.reg.TEST1.bits.AHIZEN = 1;
+  syncControl();
+  setField(R::AHIZEN, 1);
 
-  shadow.reg.SYSCONFIG1.bits.GPIO1 = GPIO_Z;
-  shadow.reg.SYSCONFIG1.bits.GPIO2 = GPIO_Z;
-  shadow.reg.SYSCONFIG1.bits.GPIO3 = GPIO_Z;
+  apply(R::GPIO1(GPIO_Z) | R::GPIO2(GPIO_Z) | R::GPIO3(GPIO_Z));
 
-  shadow.reg.POWERCFG.bits.DMUTE   = 0; // mute
-  shadow.reg.POWERCFG.bits.ENABLE  = 1;
-  shadow.reg.POWERCFG.bits.DISABLE = 1;
+  apply(R::DMUTE(0) | R::ENABLE(1) | R::DISABLE(1)); // mute, then disable
 
   putShadow();
   delay(2);
@@ -165,55 +292,86 @@ void Si4703::powerDown()
 
 // -----------------------------------------------------------------------------
 // Start device in 2-wire mode and apply default config
+// Fields are grouped per register so each group is one masked write.
 // -----------------------------------------------------------------------------
 void Si4703::start()
 {
   bus2Wire();
   powerUp();
 
-  getShadow();
+  syncControl();
 
   // Region band
   setRegion(_band, _space, _de);
-  shadow.reg.SYSCONFIG2.bits.SPACE = _space;
-  shadow.reg.SYSCONFIG2.bits.BAND  = _band;
-  shadow.reg.SYSCONFIG1.bits.DE    = _de;
-
-  // Tune
-  shadow.reg.SYSCONFIG1.bits.STCIEN = 0;
-
-  // Seek config
-  shadow.reg.POWERCFG.bits.SEEK     = 0;
-  shadow.reg.POWERCFG.bits.SEEKUP   = 1;
-  shadow.reg.POWERCFG.bits.SKMODE   = _skmode;
-  shadow.reg.SYSCONFIG2.bits.SEEKTH = _seekth;
-  shadow.reg.SYSCONFIG3.bits.SKCNT  = _skcnt;
-  shadow.reg.SYSCONFIG3.bits.SKSNR  = _sksnr;
-  shadow.reg.SYSCONFIG1.bits.AGCD   = _agcd;
-
-  // RDS
-  shadow.reg.SYSCONFIG1.bits.RDSIEN = 0;
-  shadow.reg.POWERCFG.bits.RDSM     = 0;
-  shadow.reg.SYSCONFIG1.bits.RDS    = 1;
-
-  // Audio
-  shadow.reg.TEST1.bits.AHIZEN       = 0;
-  shadow.reg.POWERCFG.bits.MONO      = 0;
-  shadow.reg.SYSCONFIG1.bits.BLNDADJ = BLA_31_49;
-  shadow.reg.SYSCONFIG2.bits.VOLUME  = 0;
-  shadow.reg.SYSCONFIG3.bits.VOLEXT  = 0;
-
-  // Softmute
-  shadow.reg.POWERCFG.bits.DSMUTE    = 1;
-  shadow.reg.SYSCONFIG3.bits.SMUTEA  = SMA_16dB;
-  shadow.reg.SYSCONFIG3.bits.SMUTER  = SMRR_Fastest;
-
-  // GPIOs
-  shadow.reg.SYSCONFIG1.bits.GPIO1 = GPIO_Z;
-  shadow.reg.SYSCONFIG1.bits.GPIO2 = GPIO_Z;
-  shadow.reg.SYSCONFIG1.bits.GPIO3 = GPIO_Z;
 
-  putShadow();
+  // POWERCFG: seek config, verbose RDS (BLERA..D are only reported with
+  // RDSM=1; in standard mode every block reads as error-free), mono, softmute
+  apply(R::SEEK(0)   | R::SEEKUP(1) | R::SKMODE(_skmode) |
+        R::RDSM(1)   | R::MONO(0)   | R::DSMUTE(1));
+
+  // SYSCONFIG1: de-emphasis, tune/RDS interrupts, RDS, AGC, blend, GPIOs
+  apply(R::DE(_de)    | R::STCIEN(0)  | R::RDSIEN(0) | R::RDS(1) |
+        R::AGCD(_agcd) | R::BLNDADJ(BLA_31_49) |
+        R::GPIO1(GPIO_Z) | R::GPIO2(GPIO_Z) | R::GPIO3(GPIO_Z));
+
+  // SYSCONFIG2: band, spacing, seek threshold, volume
+  apply(R::SPACE(_space) | R::BAND(_band) | R::SEEKTH(_seekth) | R::VOLUME(0));
+
+  // SYSCONFIG3: seek thresholds, extended volume, softmute
+  apply(R::SKCNT(_skcnt) | R::SKSNR(_sksnr) | R::VOLEXT(0) |
+        R::SMUTEA(SMA_16dB) | R::SMUTER(SMRR_Fastest));
+
+  // TEST1: audio outputs enabled
+  setField(R::AHIZEN, 0);
+
+  // Seek/Tune complete and RDS interrupts on GPIO2 -> _intPin (if connected)
+  setupInterrupt();
+
+  // From now on the shadow copy of 0x02..0x07 is the source of truth
+  if (putShadow() == 0) _ctrlCached = true;
+}
+
+// -----------------------------------------------------------------------------
+// Register modification transactions
+// Setters called between beginUpdate() and commit() only modify the shadow;
+// commit() writes everything at once (dirty range only) and completes a
+// pending setChannel(). Transactions may nest; the outermost commit writes.
+// -----------------------------------------------------------------------------
+void Si4703::beginUpdate(void)
+{
+  if (_txDepth == 0) syncControl();
+  _txDepth++;
+}
+
+byte Si4703::commit(void)
+{
+  if (_txDepth == 0) return 0;
+  if (--_txDepth > 0) return 0;
+
+  if (_txTune) {
+    // CHAN and the other changes are in the shadow; TUNE=1 joins them so a
+    // single write carries everything (held back while the previous STC is
+    // still high). A tune still in flight must drop TUNE first for a clean
+    // 0 -> 1 edge, which costs one extra write.
+    _txTune = false;
+    if (_tuning) endTune();
+
+    setField(R::TUNE, 0);
+    byte err = requestTune(R::TUNE(1).write());
+    if (err == 0) waitTune();
+    return err;
+  }
+
+  return putShadow();
+}
+
+// -----------------------------------------------------------------------------
+// Write Shadow now, or defer to commit() when inside a transaction
+// -----------------------------------------------------------------------------
+byte Si4703::applyShadow(void)
+{
+  if (_txDepth > 0) return 0;
+  return putShadow();
 }
 
 // -----------------------------------------------------------------------------
@@ -268,15 +426,15 @@ void Si4703::setRegion(int band, int space, int de)
 // -----------------------------------------------------------------------------
 void Si4703::setMono(bool en)
 {
-  getShadow();
-  shadow.reg.POWERCFG.bits.MONO = en;
-  putShadow();
+  syncControl();
+  setField(R::MONO, en);
+  applyShadow();
 }
 
 bool Si4703::getMono(void)
 {
-  getShadow();
-  return (shadow.reg.POWERCFG.bits.MONO);
+  syncControl();
+  return (field(R::MONO));
 }
 
 // -----------------------------------------------------------------------------
@@ -285,15 +443,31 @@ bool Si4703::getMono(void)
 // -----------------------------------------------------------------------------
 void Si4703::setMute(bool en)
 {
-  getShadow();
-  shadow.reg.POWERCFG.bits.DMUTE = en;
-  putShadow();
+  syncControl();
+  setField(R::DMUTE, en);
+  applyShadow();
 }
 
 bool Si4703::getMute(void)
 {
-  getShadow();
-  return (shadow.reg.POWERCFG.bits.DMUTE);
+  syncControl();
+  return (field(R::DMUTE));
+}
+
+// -----------------------------------------------------------------------------
+// Softmute (DSMUTE bit semantics: 1 = softmute disabled)
+// -----------------------------------------------------------------------------
+void Si4703::setSoftmute(bool en)
+{
+  syncControl();
+  setField(R::DSMUTE, !en);
+  applyShadow();
+}
+
+bool Si4703::getSoftmute(void)
+{
+  syncControl();
+  return !field(R::DSMUTE);
 }
 
 // -----------------------------------------------------------------------------
@@ -301,15 +475,15 @@ bool Si4703::getMute(void)
 // -----------------------------------------------------------------------------
 void Si4703::setVolExt(bool en)
 {
-  getShadow();
-  shadow.reg.SYSCONFIG3.bits.VOLEXT = en;
-  putShadow();
+  syncControl();
+  setField(R::VOLEXT, en);
+  applyShadow();
 }
 
 bool Si4703::getVolExt(void)
 {
-  getShadow();
-  return (shadow.reg.SYSCONFIG3.bits.VOLEXT);
+  syncControl();
+  return (field(R::VOLEXT));
 }
 
 // -----------------------------------------------------------------------------
@@ -317,19 +491,19 @@ bool Si4703::getVolExt(void)
 // -----------------------------------------------------------------------------
 int Si4703::getVolume(void)
 {
-  getShadow();
-  return shadow.reg.SYSCONFIG2.bits.VOLUME;
+  syncControl();
+  return field(R::VOLUME);
 }
 
 int Si4703::setVolume(int volume)
 {
-  getShadow();
+  syncControl();
 
   if (volume < 0)  volume = 0;
   if (volume > 15) volume = 15;
 
-  shadow.reg.SYSCONFIG2.bits.VOLUME = volume;
-  putShadow();
+  setField(R::VOLUME, volume);
+  applyShadow();
 
   return getVolume();
 }
@@ -349,39 +523,174 @@ int Si4703::decVolume(void)
 // -----------------------------------------------------------------------------
 int Si4703::getChannel()
 {
-  getShadow();
+  readStatus(READCHAN_WORDS, FIELD_CHANNEL);
   // Freq = Spacing * Channel + Bottom of Band.
-  return (_bandSpacing * shadow.reg.READCHAN.bits.READCHAN + _bandStart);
+  return (_bandSpacing * field(R::READCHAN) + _bandStart);
 }
 
 int Si4703::setChannel(int freq)
+{
+  if (_txDepth > 0) {
+    // Inside a transaction the tune is started and completed by commit()
+    if (freq > _bandEnd)   freq = _bandEnd;
+    if (freq < _bandStart) freq = _bandStart;
+
+    syncControl();
+    apply(R::CHAN((freq - _bandStart) / _bandSpacing) | R::TUNE(1));
+    _txTune = true;
+    return freq;
+  }
+
+  beginTune(freq);
+  waitTune();
+
+  return getChannel();
+}
+
+// -----------------------------------------------------------------------------
+// Non-blocking tune
+// beginTune() writes CHAN/TUNE and returns immediately; pollTune() reads
+// STATUSRSSI at most every TUNE_POLL_MS and clears TUNE once STC is seen.
+// The STATUSRSSI word that reported STC stays in the shadow, so RSSI/ST of
+// the new channel are available without another read.
+// -----------------------------------------------------------------------------
+void Si4703::beginTune(int freq)
 {
   if (freq > _bandEnd)   freq = _bandEnd;
   if (freq < _bandStart) freq = _bandStart;
 
-  getShadow();
-  shadow.reg.CHANNEL.bits.CHAN = (freq - _bandStart) / _bandSpacing;
-  shadow.reg.CHANNEL.bits.TUNE = 1;
-  putShadow();
+  if (_tuning) endTune(); // retune: abandon the tune in flight
+
+  requestTune((R::CHAN((freq - _bandStart) / _bandSpacing) | R::TUNE(1)).write());
+}
+
+// -----------------------------------------------------------------------------
+// STC drops shortly after TUNE/SEEK is cleared; a new tune or seek may only
+// be started once it has. If it may still be high, the write is deferred and
+// pollTune() checks STC every TUNE_POLL_MS, so begin*() never blocks.
+// -----------------------------------------------------------------------------
+byte Si4703::requestTune(Si4703Reg::Write cmd)
+{
+  _tuneCmd = cmd;
+  startTune();
+
+  // One read now (usually STC is already low), then polled
+  _stcWait = _stcPending && getSTC();
+  return _stcWait ? 0 : issueTune();
+}
+
+byte Si4703::issueTune(void)
+{
+  _stcWait    = false;
+  _stcPending = false;
+
+  syncControl();
+  apply(_tuneCmd);
+  byte err = putShadow();
+
+  startTune();
+  return err;
+}
+
+uint8_t Si4703::pollTune(void)
+{
+  if (!_tuning) return TUNE_IDLE;
 
-  if (shadow.reg.SYSCONFIG1.bits.STCIEN == 0) {
-    while (!getSTC()) {
-      // wait
+  unsigned long now = millis();
+  if (now - _tunePollMs < ((_seeking && !_stcWait) ? SEEK_POLL_MS : TUNE_POLL_MS)) return TUNE_TUNING;
+  _tunePollMs = now;
+
+  if (_stcWait) {
+    // Previous STC still high: the tune/seek itself has not been written yet
+    if (getSTC() && now - _tuneStartMs < TUNE_TIMEOUT_MS) return TUNE_TUNING;
+    issueTune();
+    return TUNE_TUNING;
+  }
+
+  bool stc = stcReady();
+
+  if (!stc && now - _tuneStartMs > (_seeking ? SEEK_TIMEOUT_MS : TUNE_TIMEOUT_MS)) {
+    stc = getSTC(); // edge may have been missed; check once
+    if (!stc) {
+      endTune();
+      return TUNE_TIMEOUT;
     }
-  } else {
-    // Interrupt-based STC not implemented
-    // TODO:
   }
 
-  getShadow();
-  shadow.reg.CHANNEL.bits.TUNE = 0;
+  if (!stc) return TUNE_TUNING;
+
+  // SFBL/RSSI/ST come from the same STATUSRSSI read that observed STC
+  _tuneStatus = shadow[R::REG_STATUSRSSI];
+  bool bandLimit = _seeking && field(R::SFBL);
+  endTune();
+
+  // TUNE was cleared right after STC was seen: the next TUNE edge may be
+  // written at once (no STC read, no poll interval), e.g. the next sweep step
+  _stcPending = false;
+  return bandLimit ? TUNE_BANDLIMIT : TUNE_DONE;
+}
+
+bool Si4703::isTuning(void)
+{
+  return _tuning;
+}
+
+bool Si4703::isSeeking(void)
+{
+  return _tuning && _seeking;
+}
+
+// -----------------------------------------------------------------------------
+// Signal of the channel just tuned, as captured together with STC. No extra
+// read is needed, which lets a sweep move on to the next channel at once.
+// -----------------------------------------------------------------------------
+int Si4703::getTuneRSSI(void)
+{
+  return R::RSSI.get(_tuneStatus);
+}
+
+bool Si4703::getTuneST(void)
+{
+  return R::ST.get(_tuneStatus);
+}
+
+// -----------------------------------------------------------------------------
+// Abort a tune or seek in flight. The device stays on the channel it had
+// reached (see getSeekProgress()).
+// -----------------------------------------------------------------------------
+void Si4703::cancelTune(void)
+{
+  if (_tuning) endTune();
+}
+
+void Si4703::startTune(void)
+{
+  _stcEdge     = false;
+  _tuning      = true;
+  _tuneStartMs = millis();
+  _tunePollMs  = _tuneStartMs;
+}
+
+void Si4703::endTune(void)
+{
+  syncControl();
+  setField(R::TUNE, 0);
+  setField(R::SEEK, 0);
   putShadow();
 
-  while (getSTC()) {
-    // wait for clear
-  }
+  _tuning     = false;
+  _seeking    = false;
+  _stcWait    = false;
+  _stcPending = true;
+}
 
-  return getChannel();
+uint8_t Si4703::waitTune(void)
+{
+  uint8_t state;
+  while ((state = pollTune()) == TUNE_TUNING) {
+    delay(1);
+  }
+  return state;
 }
 
 int Si4703::incChannel(void)
@@ -399,41 +708,101 @@ int Si4703::decChannel(void)
 // -----------------------------------------------------------------------------
 bool Si4703::getSTC(void)
 {
-  getShadow();
-  return shadow.reg.STATUSRSSI.bits.STC;
+  readStatus(STATUS_WORDS, FIELD_STC);
+  return field(R::STC);
 }
 
 // -----------------------------------------------------------------------------
-// Seek
+// Seek/tune completion check
+// In interrupt mode no bus traffic happens until GPIO2 has signalled STC;
+// the edge is then confirmed with a single STATUSRSSI read. Until the first
+// edge has ever been seen (e.g. INT line not wired) STC is polled as usual.
 // -----------------------------------------------------------------------------
-int Si4703::seek(byte seekDirection)
+bool Si4703::stcReady(void)
 {
-  getShadow();
-  shadow.reg.POWERCFG.bits.SEEKUP = seekDirection;
-  shadow.reg.POWERCFG.bits.SEEK   = 1;
-  putShadow();
+  if (_intMode && _intSeen && !_stcEdge) return false;
 
-  if (shadow.reg.SYSCONFIG1.bits.STCIEN == 0) {
-    while (!getSTC()) {
-      delay(40);
-      // seek progress optional
-    }
-  } else {
-    // Interrupt-based STC not implemented
-    // TODO:
+  _stcEdge = false;
+  return getSTC();
+}
+
+// -----------------------------------------------------------------------------
+// GPIO2 interrupt (STC). Si4703 pulls GPIO2 low for ~5 ms on completion.
+// -----------------------------------------------------------------------------
+Si4703* Si4703::_isrInstance = 0;
+
+void IRAM_ATTR Si4703::isrGPIO2(void)
+{
+  if (!_isrInstance) return;
+
+#if SI4703_RDS_TASK
+  // RDS and STC share the pin: the task reads the status and tells them apart
+  if (_isrInstance->_rdsIntMode) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(_isrInstance->_rdsTask, &woken);
+    portYIELD_FROM_ISR(woken);
+    return;
   }
+#endif
+
+  _isrInstance->_stcEdge = true;
+  _isrInstance->_intSeen = true;
+}
 
-  getShadow();
-  bool sfbl = shadow.reg.STATUSRSSI.bits.SFBL;
+void Si4703::setupInterrupt(void)
+{
+  if (_intPin <= 0) return; // no INT line: STC is polled
 
-  shadow.reg.POWERCFG.bits.SEEK = 0;
-  putShadow();
+  _isrInstance = this;
+  _stcEdge     = false;
+  _intSeen     = false;
 
-  while (getSTC()) {
-    // wait
+  // start() may run again (re-init): the pin is set up only once, but the
+  // device registers were just rewritten and need the interrupt bits again
+  if (!_intMode) {
+    pinMode(_intPin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(_intPin), isrGPIO2, FALLING);
   }
 
-  if (sfbl) return 0; // failure/band limit
+  // GPIO2 as STC interrupt output
+  apply(R::GPIO2(GPIO_I) | R::STCIEN(1));
+  _intMode = true;
+
+#if SI4703_RDS_TASK
+  // ... and as RDS-ready interrupt
+  if (!_rdsTask)        setupRDSTask();
+  else if (_rdsIntMode) apply(R::RDSIEN(1));
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Seek
+// beginSeek() starts a hardware seek and returns immediately; pollTune()
+// reports TUNE_DONE (station found), TUNE_BANDLIMIT (SFBL: nothing found /
+// band limit reached) or TUNE_TIMEOUT. cancelTune() aborts it.
+// -----------------------------------------------------------------------------
+void Si4703::beginSeek(byte seekDirection)
+{
+  if (_tuning) endTune();
+
+  requestTune((R::SEEKUP(seekDirection) | R::SEEK(1)).write());
+  _seeking = true;
+}
+
+// -----------------------------------------------------------------------------
+// Channel the device is passing through during a seek (READCHAN updates as
+// the seek progresses). Subject to the FIELD_CHANNEL max age.
+// -----------------------------------------------------------------------------
+int Si4703::getSeekProgress(void)
+{
+  return getChannel();
+}
+
+int Si4703::seek(byte seekDirection)
+{
+  beginSeek(seekDirection);
+
+  if (waitTune() != TUNE_DONE) return 0; // failure/band limit
   return getChannel();
 }
 
@@ -452,16 +821,165 @@ int Si4703::seekDown()
 // -----------------------------------------------------------------------------
 bool Si4703::getST(void)
 {
-  getShadow();
-  return shadow.reg.STATUSRSSI.bits.ST;
+  readStatus(STATUS_WORDS, FIELD_ST);
+  return field(R::ST);
 }
 
 // -----------------------------------------------------------------------------
 // RDS
 // -----------------------------------------------------------------------------
-void Si4703::readRDS(void)
+bool Si4703::readRDS(void)
 {
-  // TODO:
+  if (_rdsIntMode && _intSeen) return false;
+
+  uint32_t before = _rdsGroups;
+  getShadow(RDS_WORDS);
+  return _rdsGroups != before;
+}
+
+// -----------------------------------------------------------------------------
+// Take RDSA..RDSD with BLERA..BLERD into the ring, if RDSR says a group is
+// ready. w[] holds the first RDS_WORDS words in read order (the shadow, or
+// the interrupt task's local buffer).
+// -----------------------------------------------------------------------------
+bool Si4703::captureRDS(const uint16_t* w, unsigned long ms)
+{
+  if (!R::RDSR.get(w[R::RDSR.reg])) return false;
+
+  RdsGroup g;
+  g.block[0] = w[R::REG_RDSA];
+  g.block[1] = w[R::REG_RDSB];
+  g.block[2] = w[R::REG_RDSC];
+  g.block[3] = w[R::REG_RDSD];
+  g.bler     = RdsGroup::packBler(R::BLERA.get(w[R::BLERA.reg]), R::BLERB.get(w[R::BLERB.reg]),
+                                  R::BLERC.get(w[R::BLERC.reg]), R::BLERD.get(w[R::BLERD.reg]));
+  g.ms       = ms;
+
+  // Same group read again while RDSR is still up
+  if (_rdsGroups > 0 && (g.ms - _rdsLast.ms) < RDS_DUP_MS &&
+      memcmp(g.block, _rdsLast.block, sizeof(g.block)) == 0) {
+    return false;
+  }
+
+  _rdsLast = g;
+  _rdsGroups++;
+  _rds.push(g);
+  return true;
+}
+
+bool Si4703::getRDSGroup(RdsGroup& g)
+{
+  return _rds.pop(g);
+}
+
+uint32_t Si4703::getRDSGroups(void)
+{
+  return _rdsGroups;
+}
+
+uint32_t Si4703::getRDSDropped(void)
+{
+  return _rds.getDropped();
+}
+
+bool Si4703::isRDSInterrupt(void)
+{
+  return _rdsIntMode;
+}
+
+bool Si4703::getRDSVerbose(void)
+{
+  syncControl();
+  return field(R::RDSM);
+}
+
+#if SI4703_RDS_TASK
+// -----------------------------------------------------------------------------
+// Interrupt-driven RDS. With RDSIEN=1 the Si4703 pulses GPIO2 for every new
+// group as well as for STC. The ISR cannot use I2C, so it wakes a task that
+// reads STATUSRSSI..RDSD into its own buffer (each Wire transaction is
+// locked by the ESP32 core, the shadow is never touched) and pushes the
+// group. A loop() busy for longer than a group period loses nothing.
+// -----------------------------------------------------------------------------
+void Si4703::setupRDSTask(void)
+{
+  _readLock = xSemaphoreCreateMutex();
+  if (!_readLock) return;
+
+  if (xTaskCreate(rdsTask, "si4703rds", RDS_TASK_STACK, this, RDS_TASK_PRIO, &_rdsTask) != pdPASS) {
+    _rdsTask = 0;
+    return; // RDS stays polled
+  }
+
+  apply(R::RDSIEN(1));
+  _rdsIntMode = true;
+}
+
+void Si4703::rdsTask(void* arg)
+{
+  Si4703* radio = (Si4703*)arg;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    radio->fetchRDS();
+  }
+}
+
+void Si4703::fetchRDS(void)
+{
+  uint16_t w[RDS_WORDS];
+
+  readLock();
+  uint8_t got = Wire.requestFrom(I2C_ADDR, RDS_WORDS * 2);
+  countTransaction();
+  if (got < RDS_WORDS * 2) {
+    // Short read (bus error): drop it rather than capture 0xFFFF words
+    while (Wire.available()) Wire.read();
+    readUnlock();
+    return;
+  }
+  for (int i = 0; i < RDS_WORDS; i++) {
+    w[i] = (Wire.read() << 8) | Wire.read();
+  }
+
+  // The same pin signals STC: hand it to pollTune()
+  if (R::STC.get(w[R::REG_STATUSRSSI])) _stcEdge = true;
+  _intSeen = true;
+
+  captureRDS(w, millis());
+  readUnlock();
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Each Wire transaction is atomic, but the received bytes are read out of a
+// shared buffer afterwards; device reads must not interleave with the task's.
+// The lock also covers the RDS capture, so the ring has one producer at a time
+// (loop() captures until the interrupt line has proven to work).
+// -----------------------------------------------------------------------------
+void Si4703::readLock(void)
+{
+#if SI4703_RDS_TASK
+  if (_readLock) xSemaphoreTake(_readLock, portMAX_DELAY);
+#endif
+}
+
+void Si4703::readUnlock(void)
+{
+#if SI4703_RDS_TASK
+  if (_readLock) xSemaphoreGive(_readLock);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// RDS Programme Identification: block A of the current group, if it was
+// received without errors. Reads STATUSRSSI..RDSA (3 words).
+// -----------------------------------------------------------------------------
+uint16_t Si4703::readPI(void)
+{
+  getShadow(PI_WORDS);
+
+  if (!field(R::RDSR) || field(R::BLERA) != 0) return 0;
+  return field(R::RDSA);
 }
 
 // -----------------------------------------------------------------------------
@@ -469,17 +987,17 @@ void Si4703::readRDS(void)
 // -----------------------------------------------------------------------------
 void Si4703::writeGPIO(int GPIO, int val)
 {
-  getShadow();
+  syncControl();
 
   switch (GPIO)
   {
-    case GPIO1: shadow.reg.SYSCONFIG1.bits.GPIO1 = val; break;
-    case GPIO2: shadow.reg.SYSCONFIG1.bits.GPIO2 = val; break;
-    case GPIO3: shadow.reg.SYSCONFIG1.bits.GPIO3 = val; break;
+    case GPIO1: setField(R::GPIO1, val); break;
+    case GPIO2: setField(R::GPIO2, val); break;
+    case GPIO3: setField(R::GPIO3, val); break;
     default: break;
   }
 
-  putShadow();
+  applyShadow();
 }
 
 // -----------------------------------------------------------------------------
@@ -487,32 +1005,32 @@ void Si4703::writeGPIO(int GPIO, int val)
 // -----------------------------------------------------------------------------
 int Si4703::getPN()
 {
-  getShadow();
-  return shadow.reg.DEVICEID.bits.PN;
+  getShadow(ID_WORDS);
+  return field(R::PN);
 }
 
 int Si4703::getMFGID()
 {
-  getShadow();
-  return shadow.reg.DEVICEID.bits.MFGID;
+  getShadow(ID_WORDS);
+  return field(R::MFGID);
 }
 
 int Si4703::getREV()
 {
-  getShadow();
-  return shadow.reg.CHIPID.bits.REV;
+  getShadow(ID_WORDS);
+  return field(R::REV);
 }
 
 int Si4703::getDEV()
 {
-  getShadow();
-  return shadow.reg.CHIPID.bits.DEV;
+  getShadow(ID_WORDS);
+  return field(R::DEV);
 }
 
 int Si4703::getFIRMWARE()
 {
-  getShadow();
-  return shadow.reg.CHIPID.bits.FIRMWARE;
+  getShadow(ID_WORDS);
+  return field(R::FIRMWARE);
 }
 
 // -----------------------------------------------------------------------------
@@ -533,12 +1051,71 @@ int Si4703::getBandSpace()
   return _bandSpacing;
 }
 
+// -----------------------------------------------------------------------------
+// Status snapshot (STATUSRSSI + READCHAN from one read)
+// -----------------------------------------------------------------------------
+Si4703::Status Si4703::pollStatus(void)
+{
+  readStatus(READCHAN_WORDS, FIELD_STATUS);
+
+  Status st;
+  st.rssi     = field(R::RSSI);
+  st.stereo   = field(R::ST);
+  st.channel  = _bandSpacing * field(R::READCHAN) + _bandStart;
+  st.sfbl     = field(R::SFBL);
+  st.afcrl    = field(R::AFCRL);
+  st.rdsReady = field(R::RDSR);
+  st.bler[0]  = field(R::BLERA);
+  st.bler[1]  = field(R::BLERB);
+  st.bler[2]  = field(R::BLERC);
+  st.bler[3]  = field(R::BLERD);
+  return st;
+}
+
+// -----------------------------------------------------------------------------
+// Write-back statistics
+// -----------------------------------------------------------------------------
+uint32_t Si4703::getBytesSaved(void)
+{
+  return _bytesSaved;
+}
+
+uint32_t Si4703::getTransactions(void)
+{
+  return __atomic_load_n(&_transactions, __ATOMIC_RELAXED);
+}
+
+// Also called from the RDS task: the increment must be atomic
+void Si4703::countTransaction(void)
+{
+  __atomic_fetch_add(&_transactions, 1, __ATOMIC_RELAXED);
+}
+
+// -----------------------------------------------------------------------------
+// Status read cache control and statistics
+// -----------------------------------------------------------------------------
+void Si4703::setMaxAge(uint8_t field, uint16_t ms)
+{
+  if (field >= FIELD_COUNT || field == FIELD_STC) return; // STC must always be fresh
+  _maxAge[field] = ms;
+}
+
+uint32_t Si4703::getCacheHits(void)
+{
+  return _cacheHits;
+}
+
+uint32_t Si4703::getCacheMisses(void)
+{
+  return _cacheMisses;
+}
+
 // -----------------------------------------------------------------------------
 // RSSI
 // -----------------------------------------------------------------------------
 int Si4703::getRSSI(void)
 {
-  getShadow();
-  return shadow.reg.STATUSRSSI.bits.RSSI;
+  readStatus(STATUS_WORDS, FIELD_RSSI);
+  return field(R::RSSI);
 }
 
@@ -28,6 +28,22 @@
 #define Si4703_h
 
 #include "Arduino.h"
+#include "Si4703Regs.h"
+#include "RdsGroup.h"
+
+#ifndef IRAM_ATTR
+  #define IRAM_ATTR               // ISR placement attribute (ESP32 only)
+#endif
+
+// RDS groups fetched by a FreeRTOS task woken from the GPIO2 interrupt
+// (ESP32 only; elsewhere, or with 0, RDS is polled with readRDS())
+#ifndef SI4703_RDS_TASK
+  #if defined(ARDUINO_ARCH_ESP32)
+    #define SI4703_RDS_TASK 1
+  #else
+    #define SI4703_RDS_TASK 0
+  #endif
+#endif
 
 // --------------------------- Default pins per architecture ---------------------------
 // For ESP32-S3 Super Mini (your setup): I2C SDA=7, SCL=8, RST=9
@@ -100,6 +116,21 @@ static const uint8_t 	BLA_37_55		= 0b01;	// 37–55 RSSI dBμV (+6 dB)
 static const uint8_t 	BLA_19_37		= 0b10;	// 19–37 RSSI dBμV (–12 dB)
 static const uint8_t 	BLA_25_43		= 0b11;	// 25–43 RSSI dBμV (–6 dB)
 
+// Status fields with individually configurable cache freshness (setMaxAge)
+static const uint8_t 	FIELD_RSSI		= 0;	// getRSSI()
+static const uint8_t 	FIELD_ST		= 1;	// getST()
+static const uint8_t 	FIELD_CHANNEL	= 2;	// getChannel()
+static const uint8_t 	FIELD_STC		= 3;	// Seek/Tune Complete polling (always read, not configurable)
+static const uint8_t 	FIELD_STATUS	= 4;	// pollStatus() snapshot
+static const uint8_t 	FIELD_COUNT		= 5;
+
+// Tune progress (pollTune)
+static const uint8_t 	TUNE_IDLE		= 0;	// No tune in flight
+static const uint8_t 	TUNE_TUNING		= 1;	// Waiting for STC
+static const uint8_t 	TUNE_DONE		= 2;	// Tune complete (reported once)
+static const uint8_t 	TUNE_TIMEOUT	= 3;	// STC not seen in time, tune aborted
+static const uint8_t 	TUNE_BANDLIMIT	= 4;	// Seek failed / reached band limit (SFBL)
+
 //------------------------------------------------------------------------------------------------------------
 
 class Si4703
@@ -110,7 +141,7 @@ class Si4703
       int rstPin  = SI4703_DEFAULT_RST,  // Reset Pin
       int sdioPin = SI4703_DEFAULT_SDA,  // I2C Data IO Pin (SDA)
       int sclkPin = SI4703_DEFAULT_SCL,  // I2C Clock Pin (SCL)
-      int intPin  = 0,                   // Seek/Tune Complete and RDS interrupt Pin
+      int intPin  = 0,                   // Seek/Tune Complete and RDS interrupt Pin (0 = not used)
 
       // Band Settings
       int band    = BAND_US_EU,          // Band Range
@@ -128,6 +159,12 @@ class Si4703
     void  powerUp();             // Power Up radio device
     void  powerDown();           // Power Down radio device to save power
     void  start();               // start radio
+    void  resync();              // Re-read all registers into the control cache
+
+    // Batched register modification: setters between beginUpdate() and
+    // commit() are written in one transaction (e.g. preset recall)
+    void  beginUpdate(void);     // Start collecting setter changes
+    byte  commit(void);          // Write collected changes (and finish a tune)
 
     int   getPN();               // Get DeviceID:Part Number
     int   getMFGID();            // Get DeviceID:Manufacturer ID
@@ -141,8 +178,37 @@ class Si4703
 
     int   getRSSI(void);         // Get RSSI current value
 
+    // Snapshot of STATUSRSSI + READCHAN taken in a single bus transaction
+    struct Status
+    {
+      int     rssi;              // RSSI (dBuV)
+      bool    stereo;            // ST: stereo indicator
+      int     channel;           // Tuned frequency (10kHz units)
+      bool    sfbl;              // Seek Fail/Band Limit
+      bool    afcrl;             // AFC Rail
+      bool    rdsReady;          // RDSR: new RDS group available
+      uint8_t bler[4];           // Block A..D error levels (0=none .. 3=uncorrectable)
+    };
+
+    Status pollStatus(void);     // Read all status fields at once (4 bytes)
+
     int   getChannel(void);      // Get current frequency (in 10kHz units, e.g. 8760 => 87.60MHz)
-    int   setChannel(int freq);  // Set frequency (same unit)
+    int   setChannel(int freq);  // Set frequency (same unit), blocks until tuned
+
+    // Non-blocking tune/seek: begin*() starts it, pollTune() advances it
+    void    beginTune(int freq); // Start tuning (same unit)
+    void    beginSeek(byte dir); // Start seeking (SEEK_UP / SEEK_DOWN)
+    uint8_t pollTune(void);      // TUNE_IDLE / _TUNING / _DONE / _TIMEOUT / _BANDLIMIT
+    void    cancelTune(void);    // Abort tune/seek in flight
+    bool    isTuning(void);      // Tune or seek in flight
+    bool    isSeeking(void);     // Seek in flight
+    int     getSeekProgress(void); // Channel currently passed by the seek
+    int     getTuneRSSI(void);   // RSSI sampled by the read that observed STC
+    bool    getTuneST(void);     // Stereo flag from that same read
+
+    static const byte SEEK_DOWN = 0;
+    static const byte SEEK_UP   = 1;
+
     int   incChannel(void);      // Increment one band step
     int   decChannel(void);      // Decrement one band step
 
@@ -158,6 +224,10 @@ class Si4703
     void  setMute(bool en);      // en maps to DMUTE bit (1=unmute, 0=mute)
     bool  getMute(void);         // returns DMUTE bit (1=unmute, 0=mute)
 
+    // NOTE: Si4703 DSMUTE bit semantics: 1 = softmute disabled.
+    void  setSoftmute(bool en);  // 1=Enable softmute (DSMUTE=0)
+    bool  getSoftmute(void);     // Get softmute status
+
     void  setVolExt(bool en);    // Set Extended Volume Range
     bool  getVolExt(void);       // Get Extended Volume Range
     int   getVolume(void);       // Get current Volume value
@@ -165,11 +235,30 @@ class Si4703
     int   incVolume(void);       // Increment Volume
     int   decVolume(void);       // Decrement Volume
 
-    void  readRDS(void);         // Reads RDS (TODO in this lib)
+    // RDS: any read covering RDSA..RDSD captures the group into a ring buffer
+    bool  readRDS(void);         // One STATUSRSSI..RDSD read; true if a new group was captured
+                                 // (no-op while the interrupt task captures groups)
+    bool  isRDSInterrupt(void);  // Groups captured by the GPIO2 interrupt task
+    bool  getRDSVerbose(void);   // RDSM=1: BLERA..BLERD report real block error levels
+    bool  getRDSGroup(RdsGroup& g); // Oldest captured group (false if none)
+    uint32_t getRDSGroups(void); // Groups captured so far
+    uint32_t getRDSDropped(void);// Groups lost to a full ring
+    uint16_t readPI(void);       // RDS PI from an error-free block A, or 0
 
     void  writeGPIO(int GPIO,    // Write to GPIO1,GPIO2, and GPIO3
                     int val);    // values: GPIO_Z, GPIO_I, GPIO_Low, GPIO_High
 
+    uint32_t getBytesSaved(void); // I2C write bytes skipped by dirty-range write-back
+    uint32_t getTransactions(void); // I2C transactions issued to the device so far
+
+    // Status read coalescing: a query is served from the shadow when the last
+    // read is younger than the field's max age (0 = always read, default).
+    // STC is never served from the shadow: FIELD_STC is ignored here, and
+    // Status carries no STC (use pollTune()).
+    void     setMaxAge(uint8_t field, uint16_t ms);
+    uint32_t getCacheHits(void);  // status queries served from the shadow
+    uint32_t getCacheMisses(void);// status queries that went to the bus
+
   private:
     // MCU Pins Selection
     int _rstPin;
@@ -192,9 +281,73 @@ class Si4703
     int _sksnr;
     int _agcd;
 
+    // Control registers (0x02..0x07) as last written to the device
+    uint16_t _written[6];
+    bool     _writtenValid;
+    bool     _ctrlCached;        // control regs served from shadow (after start)
+    uint32_t _bytesSaved;
+    uint32_t _transactions;
+
+    // Transactions
+    uint8_t  _txDepth;           // nesting level of beginUpdate()
+    bool     _txTune;            // setChannel() pending until commit()
+
+    // Tune state machine
+    bool          _tuning;       // waiting for STC
+    bool          _seeking;      // ... of a seek (SEEK bit set)
+    bool          _stcPending;   // TUNE cleared, STC may still be high
+    bool          _stcWait;      // tune/seek requested, waiting for STC to drop
+    Si4703Reg::Write _tuneCmd;   // TUNE/SEEK write issued once STC is low
+    unsigned long _tuneStartMs;
+    unsigned long _tunePollMs;   // last STC poll
+    uint16_t      _tuneStatus;   // STATUSRSSI word that reported STC
+
+    // GPIO2 interrupt
+    static Si4703* _isrInstance; // instance served by isrGPIO2()
+    bool          _intMode;      // STCIEN set, GPIO2 routed to _intPin
+    volatile bool _intSeen;      // INT line has delivered an edge (wired)
+    volatile bool _stcEdge;      // edge since last stcReady()
+
+    // Status read cache
+    unsigned long _shadowMs;            // millis() of last shadow read
+    uint8_t       _shadowWords;         // words valid from that read (0 = stale)
+    uint16_t      _maxAge[FIELD_COUNT]; // per-field freshness window (ms)
+    uint32_t      _cacheHits;
+    uint32_t      _cacheMisses;
+
+    // RDS capture
+    RdsRing       _rds;
+    RdsGroup      _rdsLast;             // last captured group (duplicate filter)
+    uint32_t      _rdsGroups;
+    bool          _rdsIntMode;          // RDSIEN set, _rdsTask is the only producer
+#if SI4703_RDS_TASK
+    TaskHandle_t  _rdsTask;
+    SemaphoreHandle_t _readLock;        // Wire RX buffer: task vs. loop() reads
+#endif
+
     // Private Functions
-    void  getShadow();
+    void  getShadow(uint8_t words = SHADOW_WORDS); // Read first N words (from 0x0A)
+    void  syncControl(void);     // Ensure control regs in shadow are current
+    void  readStatus(uint8_t words, uint8_t field); // getShadow() unless fresh enough
+    bool  captureRDS(const uint16_t* w, unsigned long ms); // STATUSRSSI..RDSD -> ring if RDSR is set
+#if SI4703_RDS_TASK
+    void  setupRDSTask(void);    // RDSIEN on GPIO2, fetch task
+    void  fetchRDS(void);        // Task: one STATUSRSSI..RDSD read into a local buffer
+    static void rdsTask(void* arg);
+#endif
+    void  countTransaction(void); // _transactions++ (loop() and RDS task)
+    void  readLock(void);        // Serialize requestFrom()+read() with the task
+    void  readUnlock(void);
     byte  putShadow();
+    byte  applyShadow(void);     // putShadow() unless inside a transaction
+    void  startTune(void);       // Tune written: start waiting for STC
+    void  endTune(void);         // Clear TUNE after STC (or timeout)
+    byte  requestTune(Si4703Reg::Write cmd); // Issue cmd now, or once STC has dropped
+    byte  issueTune(void);       // Write _tuneCmd (with all pending changes), wait for STC
+    uint8_t waitTune(void);      // Blocking pollTune() loop
+    bool  stcReady(void);        // STC seen (interrupt edge or poll)
+    void  setupInterrupt(void);  // GPIO2 -> _intPin STC interrupt
+    static void isrGPIO2(void);  // _intPin falling edge
     void  bus3Wire(void);
     void  bus2Wire(void);
     void  setRegion(int band, int space, int de);
@@ -205,186 +358,58 @@ class Si4703
     static const int      I2C_ADDR     = 0x10;
     static const uint16_t I2C_FAIL_MAX = 10;
 
-    static const uint16_t SEEK_DOWN = 0;
-    static const uint16_t SEEK_UP   = 1;
-
-    // Registers shadow
-    union DEVICEID_t
-    {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t MFGID :12;
-        uint8_t  PN    :4;
-      } bits;
-    };
-
-    union CHIPID_t
+    // Partial read sizes (in 16-bit words, counted from 0x0A in read order)
+    static const uint8_t  STATUS_WORDS   = 1;  // 0x0A          STATUSRSSI
+    static const uint8_t  READCHAN_WORDS = 2;  // 0x0A..0x0B    + READCHAN
+    static const uint8_t  PI_WORDS       = 3;  // 0x0A..0x0C    + RDSA
+    static const uint8_t  RDS_WORDS      = 6;  // 0x0A..0x0F    + RDSB..RDSD
+    static const uint8_t  ID_WORDS       = 8;  // 0x0A..0x01    + RDS, DEVICEID, CHIPID
+    static const uint8_t  CONTROL_WORDS  = 14; // 0x0A..0x07    + POWERCFG..TEST1
+    static const uint8_t  SHADOW_WORDS   = 16; // 0x0A..0x09    entire register set
+
+    // Writable control registers 0x02..0x07 (shadow word index 8..13)
+    static const uint8_t  CTRL_FIRST     = Si4703Reg::REG_POWERCFG;
+    static const uint8_t  CTRL_COUNT     = 6;
+
+    // Tune timing
+    static const uint16_t TUNE_POLL_MS    = 5;   // STC poll interval while tuning
+    static const uint16_t TUNE_TIMEOUT_MS = 250; // datasheet tune time is 60 ms max
+    static const uint16_t SEEK_POLL_MS    = 40;  // STC poll interval while seeking
+    static const uint16_t SEEK_TIMEOUT_MS = 15000; // full band at ~60 ms per channel
+
+    // RDSR stays up for a while after a group; a re-read of the same group
+    // within this window is not a new group (groups arrive every 87.6 ms)
+    static const uint16_t RDS_DUP_MS      = 80;
+    static const uint16_t RDS_TASK_STACK  = 2048;
+    static const uint8_t  RDS_TASK_PRIO   = 5;  // above loop() (1)
+
+
+    // Registers shadow, in device read order (0x0A..0x0F, 0x00..0x09).
+    // Fields are accessed through the descriptors in Si4703Regs.h.
+    uint16_t shadow[Si4703Reg::REG_COUNT];
+
+    template <uint8_t REG>
+    uint16_t field(Si4703Reg::Field<REG> f) const
     {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t FIRMWARE:6;
-        uint16_t DEV     :4;
-        uint16_t REV     :6;
-      } bits;
-    };
+      return f.get(shadow[REG]);
+    }
 
-    union POWERCFG_t
+    template <uint8_t REG>
+    void setField(Si4703Reg::Field<REG> f, uint16_t val)
     {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t ENABLE :1;
-        uint16_t        :5;
-        uint16_t DISABLE:1;
-        uint16_t        :1;
-        uint16_t SEEK   :1;
-        uint16_t SEEKUP :1;
-        uint16_t SKMODE :1;
-        uint16_t RDSM   :1;
-        uint16_t        :1;
-        uint16_t MONO   :1;
-        uint16_t DMUTE  :1;
-        uint16_t DSMUTE :1;
-      } bits;
-    };
+      shadow[REG] = f.put(shadow[REG], val);
+    }
 
-    union CHANNEL_t
+    template <uint8_t REG>
+    void apply(Si4703Reg::Update<REG> u) // several fields of one register at once
     {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t CHAN:10;
-        uint16_t     :5;
-        uint16_t TUNE:1;
-      } bits;
-    };
-
-    union SYSCONFIG1_t
-    {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t GPIO1  :2;
-        uint16_t GPIO2  :2;
-        uint16_t GPIO3  :2;
-        uint16_t BLNDADJ:2;
-        uint16_t        :2;
-        uint16_t AGCD   :1;
-        uint16_t DE     :1;
-        uint16_t RDS    :1;
-        uint16_t        :1;
-        uint16_t STCIEN :1;
-        uint16_t RDSIEN :1;
-      } bits;
-    };
-
-    union SYSCONFIG2_t
-    {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t VOLUME:4;
-        uint16_t SPACE :2;
-        uint16_t BAND  :2;
-        uint16_t SEEKTH:8;
-      } bits;
-    };
-
-    union SYSCONFIG3_t
-    {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t SKCNT :4;
-        uint16_t SKSNR :4;
-        uint16_t VOLEXT:1;
-        uint16_t       :3;
-        uint16_t SMUTEA:2;
-        uint16_t SMUTER:2;
-      } bits;
-    };
-
-    union TEST1_t
-    {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t       :14;
-        uint16_t AHIZEN:1;
-        uint16_t XOSCEN:1;
-      } bits;
-    };
-
-    union TEST2_t
-    {
-      uint16_t word;
-      struct bits { uint16_t :16; } bits;
-    };
-
-    union BOOTCONFIG_t
-    {
-      uint16_t word;
-      struct bits { uint16_t :16; } bits;
-    };
-
-    union STATUSRSSI_t
-    {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t RSSI :8;
-        uint16_t ST   :1;
-        uint16_t BLERA:2;
-        uint16_t RDSS :1;
-        uint16_t AFCRL:1;
-        uint16_t SFBL :1;
-        uint16_t STC  :1;
-        uint16_t RDSR :1;
-      } bits;
-    };
-
-    union READCHAN_t
-    {
-      uint16_t word;
-      struct bits
-      {
-        uint16_t READCHAN:10;
-        uint16_t BLERD   :2;
-        uint16_t BLERC   :2;
-        uint16_t BLERB   :2;
-      } bits;
-    };
-
-    union RDSA_t { uint16_t word; struct bits { uint16_t RDSA:16; } bits; };
-    union RDSB_t { uint16_t word; struct bits { uint16_t RDSB:16; } bits; };
-    union RDSC_t { uint16_t word; struct bits { uint16_t RDSC:16; } bits; };
-    union RDSD_t { uint16_t word; struct bits { uint16_t RDSD:16; } bits; };
+      apply(u.write());
+    }
 
-    union shadow_t
+    void apply(Si4703Reg::Write w)
     {
-      uint16_t word[16];
-      struct reg
-      {
-        STATUSRSSI_t STATUSRSSI; // 0x0A
-        READCHAN_t   READCHAN;   // 0x0B
-        RDSA_t       RDSA;       // 0x0C
-        RDSB_t       RDSB;       // 0x0D
-        RDSC_t       RDSC;       // 0x0E
-        RDSD_t       RDSD;       // 0x0F
-        DEVICEID_t   DEVICEID;   // 0x00
-        CHIPID_t     CHIPID;     // 0x01
-        POWERCFG_t   POWERCFG;   // 0x02
-        CHANNEL_t    CHANNEL;    // 0x03
-        SYSCONFIG1_t SYSCONFIG1; // 0x04
-        SYSCONFIG2_t SYSCONFIG2; // 0x05
-        SYSCONFIG3_t SYSCONFIG3; // 0x06
-        TEST1_t      TEST1;      // 0x07
-        TEST2_t      TEST2;      // 0x08
-        BOOTCONFIG_t BOOTCONFIG; // 0x09
-      } reg;
-    } shadow;
+      shadow[w.reg] = (uint16_t)((shadow[w.reg] & ~w.mask) | w.bits);
+    }
 };
 
 #endif
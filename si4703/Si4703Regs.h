@@ -0,0 +1,216 @@
+/*
+ *  Si4703 register map as constexpr field descriptors
+ *
+ *  Each field is described by the shadow word it lives in, its LSB position
+ *  and its width. Unlike bitfield unions, the layout does not depend on the
+ *  compiler, so this header behaves identically on ESP32 and on a Linux host.
+ *  Masks are verified against the datasheet with static_assert below.
+ *
+ *  Several fields of one register can be combined into a single masked
+ *  write:  apply(Si4703Reg::MONO(1) | Si4703Reg::DMUTE(0))
+ *  Combining fields of different registers does not compile (the register
+ *  is a template parameter of Field and Update).
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef Si4703Regs_h
+#define Si4703Regs_h
+
+#include <stdint.h>
+
+namespace Si4703Reg
+{
+  // Shadow word index of each register (device read order starts at 0x0A)
+  constexpr uint8_t REG_STATUSRSSI = 0;   // 0x0A
+  constexpr uint8_t REG_READCHAN   = 1;   // 0x0B
+  constexpr uint8_t REG_RDSA       = 2;   // 0x0C
+  constexpr uint8_t REG_RDSB       = 3;   // 0x0D
+  constexpr uint8_t REG_RDSC       = 4;   // 0x0E
+  constexpr uint8_t REG_RDSD       = 5;   // 0x0F
+  constexpr uint8_t REG_DEVICEID   = 6;   // 0x00
+  constexpr uint8_t REG_CHIPID     = 7;   // 0x01
+  constexpr uint8_t REG_POWERCFG   = 8;   // 0x02
+  constexpr uint8_t REG_CHANNEL    = 9;   // 0x03
+  constexpr uint8_t REG_SYSCONFIG1 = 10;  // 0x04
+  constexpr uint8_t REG_SYSCONFIG2 = 11;  // 0x05
+  constexpr uint8_t REG_SYSCONFIG3 = 12;  // 0x06
+  constexpr uint8_t REG_TEST1      = 13;  // 0x07
+  constexpr uint8_t REG_TEST2      = 14;  // 0x08
+  constexpr uint8_t REG_BOOTCONFIG = 15;  // 0x09
+  constexpr uint8_t REG_COUNT      = 16;
+
+  // Shadow index of a device register address
+  constexpr uint8_t index(uint8_t addr) { return (uint8_t)((addr + 6) & 0x0F); }
+
+  // A masked write of one register, bound at run time (e.g. a deferred write)
+  struct Write
+  {
+    uint8_t  reg;
+    uint16_t mask;
+    uint16_t bits;
+  };
+
+  // Several fields of register REG, merged into one masked write. The
+  // register is part of the type: merging fields of different registers
+  // does not compile, whether the values are constant or not.
+  template <uint8_t REG>
+  struct Update
+  {
+    uint16_t mask;
+    uint16_t bits;
+
+    constexpr Update operator|(Update o) const
+    {
+      return Update{ (uint16_t)(mask | o.mask), (uint16_t)(bits | o.bits) };
+    }
+
+    constexpr Write write() const
+    {
+      return Write{ REG, mask, bits };
+    }
+  };
+
+  template <uint8_t REG>
+  struct Field
+  {
+    static constexpr uint8_t reg = REG; // shadow word index
+    uint8_t shift;  // LSB position
+    uint8_t width;  // number of bits
+
+    constexpr uint16_t mask() const
+    {
+      return (uint16_t)(((1UL << width) - 1UL) << shift);
+    }
+
+    constexpr uint16_t get(uint16_t word) const
+    {
+      return (uint16_t)((word & mask()) >> shift);
+    }
+
+    constexpr uint16_t put(uint16_t word, uint16_t val) const
+    {
+      return (uint16_t)((word & ~mask()) | (((uint32_t)val << shift) & mask()));
+    }
+
+    constexpr Update<REG> operator()(uint16_t val) const
+    {
+      return Update<REG>{ mask(), (uint16_t)(((uint32_t)val << shift) & mask()) };
+    }
+  };
+
+  template <uint8_t REG> constexpr uint8_t Field<REG>::reg;
+
+  // 0x00 DEVICEID
+  constexpr Field<REG_DEVICEID>   MFGID    = {  0, 12 };
+  constexpr Field<REG_DEVICEID>   PN       = { 12,  4 };
+
+  // 0x01 CHIPID
+  constexpr Field<REG_CHIPID>     FIRMWARE = {  0,  6 };
+  constexpr Field<REG_CHIPID>     DEV      = {  6,  4 };
+  constexpr Field<REG_CHIPID>     REV      = { 10,  6 };
+
+  // 0x02 POWERCFG
+  constexpr Field<REG_POWERCFG>   ENABLE   = {  0,  1 };
+  constexpr Field<REG_POWERCFG>   DISABLE  = {  6,  1 };
+  constexpr Field<REG_POWERCFG>   SEEK     = {  8,  1 };
+  constexpr Field<REG_POWERCFG>   SEEKUP   = {  9,  1 };
+  constexpr Field<REG_POWERCFG>   SKMODE   = { 10,  1 };
+  constexpr Field<REG_POWERCFG>   RDSM     = { 11,  1 };
+  constexpr Field<REG_POWERCFG>   MONO     = { 13,  1 };
+  constexpr Field<REG_POWERCFG>   DMUTE    = { 14,  1 };
+  constexpr Field<REG_POWERCFG>   DSMUTE   = { 15,  1 };
+
+  // 0x03 CHANNEL
+  constexpr Field<REG_CHANNEL>    CHAN     = {  0, 10 };
+  constexpr Field<REG_CHANNEL>    TUNE     = { 15,  1 };
+
+  // 0x04 SYSCONFIG1
+  constexpr Field<REG_SYSCONFIG1> GPIO1    = {  0,  2 };
+  constexpr Field<REG_SYSCONFIG1> GPIO2    = {  2,  2 };
+  constexpr Field<REG_SYSCONFIG1> GPIO3    = {  4,  2 };
+  constexpr Field<REG_SYSCONFIG1> BLNDADJ  = {  6,  2 };
+  constexpr Field<REG_SYSCONFIG1> AGCD     = { 10,  1 };
+  constexpr Field<REG_SYSCONFIG1> DE       = { 11,  1 };
+  constexpr Field<REG_SYSCONFIG1> RDS      = { 12,  1 };
+  constexpr Field<REG_SYSCONFIG1> STCIEN   = { 14,  1 };
+  constexpr Field<REG_SYSCONFIG1> RDSIEN   = { 15,  1 };
+
+  // 0x05 SYSCONFIG2
+  constexpr Field<REG_SYSCONFIG2> VOLUME   = {  0,  4 };
+  constexpr Field<REG_SYSCONFIG2> SPACE    = {  4,  2 };
+  constexpr Field<REG_SYSCONFIG2> BAND     = {  6,  2 };
+  constexpr Field<REG_SYSCONFIG2> SEEKTH   = {  8,  8 };
+
+  // 0x06 SYSCONFIG3
+  constexpr Field<REG_SYSCONFIG3> SKCNT    = {  0,  4 };
+  constexpr Field<REG_SYSCONFIG3> SKSNR    = {  4,  4 };
+  constexpr Field<REG_SYSCONFIG3> VOLEXT   = {  8,  1 };
+  constexpr Field<REG_SYSCONFIG3> SMUTEA   = { 12,  2 };
+  constexpr Field<REG_SYSCONFIG3> SMUTER   = { 14,  2 };
+
+  // 0x07 TEST1
+  constexpr Field<REG_TEST1>      AHIZEN   = { 14,  1 };
+  constexpr Field<REG_TEST1>      XOSCEN   = { 15,  1 };
+
+  // 0x0A STATUSRSSI
+  constexpr Field<REG_STATUSRSSI> RSSI     = {  0,  8 };
+  constexpr Field<REG_STATUSRSSI> ST       = {  8,  1 };
+  constexpr Field<REG_STATUSRSSI> BLERA    = {  9,  2 };
+  constexpr Field<REG_STATUSRSSI> RDSS     = { 11,  1 };
+  constexpr Field<REG_STATUSRSSI> AFCRL    = { 12,  1 };
+  constexpr Field<REG_STATUSRSSI> SFBL     = { 13,  1 };
+  constexpr Field<REG_STATUSRSSI> STC      = { 14,  1 };
+  constexpr Field<REG_STATUSRSSI> RDSR     = { 15,  1 };
+
+  // 0x0B READCHAN
+  constexpr Field<REG_READCHAN>   READCHAN = {  0, 10 };
+  constexpr Field<REG_READCHAN>   BLERD    = { 10,  2 };
+  constexpr Field<REG_READCHAN>   BLERC    = { 12,  2 };
+  constexpr Field<REG_READCHAN>   BLERB    = { 14,  2 };
+
+  // 0x0C..0x0F RDS blocks
+  constexpr Field<REG_RDSA>       RDSA     = {  0, 16 };
+  constexpr Field<REG_RDSB>       RDSB     = {  0, 16 };
+  constexpr Field<REG_RDSC>       RDSC     = {  0, 16 };
+  constexpr Field<REG_RDSD>       RDSD     = {  0, 16 };
+
+  // ------------------------------ Layout checks (datasheet masks) ------------------------------
+  static_assert(index(0x0A) == REG_STATUSRSSI && index(0x00) == REG_DEVICEID &&
+                index(0x02) == REG_POWERCFG && index(0x09) == REG_BOOTCONFIG, "read order");
+
+  static_assert((MFGID.mask() | PN.mask()) == 0xFFFF && (MFGID.mask() & PN.mask()) == 0, "DEVICEID");
+  static_assert((FIRMWARE.mask() | DEV.mask() | REV.mask()) == 0xFFFF, "CHIPID");
+
+  static_assert(ENABLE.mask() == 0x0001 && DISABLE.mask() == 0x0040 && SEEK.mask() == 0x0100 &&
+                SEEKUP.mask() == 0x0200 && SKMODE.mask() == 0x0400 && RDSM.mask() == 0x0800 &&
+                MONO.mask() == 0x2000 && DMUTE.mask() == 0x4000 && DSMUTE.mask() == 0x8000, "POWERCFG");
+
+  static_assert(CHAN.mask() == 0x03FF && TUNE.mask() == 0x8000, "CHANNEL");
+
+  static_assert(GPIO1.mask() == 0x0003 && GPIO2.mask() == 0x000C && GPIO3.mask() == 0x0030 &&
+                BLNDADJ.mask() == 0x00C0 && AGCD.mask() == 0x0400 && DE.mask() == 0x0800 &&
+                RDS.mask() == 0x1000 && STCIEN.mask() == 0x4000 && RDSIEN.mask() == 0x8000, "SYSCONFIG1");
+
+  static_assert(VOLUME.mask() == 0x000F && SPACE.mask() == 0x0030 && BAND.mask() == 0x00C0 &&
+                SEEKTH.mask() == 0xFF00, "SYSCONFIG2");
+
+  static_assert(SKCNT.mask() == 0x000F && SKSNR.mask() == 0x00F0 && VOLEXT.mask() == 0x0100 &&
+                SMUTEA.mask() == 0x3000 && SMUTER.mask() == 0xC000, "SYSCONFIG3");
+
+  static_assert(AHIZEN.mask() == 0x4000 && XOSCEN.mask() == 0x8000, "TEST1");
+
+  static_assert(RSSI.mask() == 0x00FF && ST.mask() == 0x0100 && BLERA.mask() == 0x0600 &&
+                RDSS.mask() == 0x0800 && AFCRL.mask() == 0x1000 && SFBL.mask() == 0x2000 &&
+                STC.mask() == 0x4000 && RDSR.mask() == 0x8000, "STATUSRSSI");
+
+  static_assert(READCHAN.mask() == 0x03FF && BLERD.mask() == 0x0C00 && BLERC.mask() == 0x3000 &&
+                BLERB.mask() == 0xC000, "READCHAN");
+
+  static_assert(RDSA.mask() == 0xFFFF, "RDS blocks");
+
+  // A merged update is one read-modify-write of one word
+  static_assert((MONO(1) | DMUTE(0)).mask == 0x6000 && (MONO(1) | DMUTE(0)).bits == 0x2000, "Update");
+}
+
+#endif
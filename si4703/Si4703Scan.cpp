@@ -0,0 +1,360 @@
+/*
+ *  Si4703 band scan
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#include "Arduino.h"
+#include "Si4703Scan.h"
+
+// -----------------------------------------------------------------------------
+// Station table
+// -----------------------------------------------------------------------------
+StationTable::StationTable()
+{
+  _count = 0;
+}
+
+void StationTable::clear(void)
+{
+  _count = 0;
+}
+
+bool StationTable::add(const StationInfo& st)
+{
+  int i = find(st.freq);
+  if (i >= 0) {
+    _st[i] = st;
+    return true;
+  }
+
+  if (_count == CAPACITY) {
+    // Full: the weakest station makes room for a stronger one
+    int weakest = 0;
+    for (int k = 1; k < _count; k++) {
+      if (_st[k].rssi < _st[weakest].rssi) weakest = k;
+    }
+    if (_st[weakest].rssi >= st.rssi) return false;
+
+    remove(weakest);
+  }
+
+  // Insertion keeps the table sorted by frequency
+  int pos = _count;
+  while (pos > 0 && _st[pos - 1].freq > st.freq) {
+    _st[pos] = _st[pos - 1];
+    pos--;
+  }
+  _st[pos] = st;
+  _count++;
+  return true;
+}
+
+void StationTable::remove(uint8_t i)
+{
+  if (i >= _count) return;
+  for (int k = i; k < _count - 1; k++) _st[k] = _st[k + 1];
+  _count--;
+}
+
+int StationTable::find(int freq) const
+{
+  int lo = 0, hi = _count - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    if (_st[mid].freq == freq) return mid;
+    if (_st[mid].freq < freq) lo = mid + 1;
+    else                      hi = mid - 1;
+  }
+  return -1;
+}
+
+int StationTable::next(int freq, int dir) const
+{
+  if (dir > 0) {
+    for (int i = 0; i < _count; i++) {
+      if (_st[i].freq > freq) return i;
+    }
+  } else {
+    for (int i = _count - 1; i >= 0; i--) {
+      if (_st[i].freq < freq) return i;
+    }
+  }
+  return -1;
+}
+
+void StationTable::load(const StationInfo* src, uint8_t n)
+{
+  clear();
+  for (int i = 0; i < n; i++) add(src[i]);
+}
+
+// -----------------------------------------------------------------------------
+// Scanner
+// -----------------------------------------------------------------------------
+Si4703Scanner::Si4703Scanner(Si4703& radio, StationTable& table)
+  : _radio(radio), _table(table)
+{
+  _map          = 0;
+  _hook         = 0;
+  _phase        = PH_IDLE;
+  _mode         = SCAN_SEEK;
+  _muteWas      = true;
+  _piDwellMs    = 0;
+  _dwellStartMs = 0;
+  _dwellPollMs  = 0;
+  _progress     = 0;
+  _samples      = 0;
+  _startMs      = 0;
+  _startTx      = 0;
+  _elapsedMs    = 0;
+  _transactions = 0;
+
+  _criteria.rssiMin       = 20;
+  _criteria.localPeak     = true;
+  _criteria.requireStereo = false;
+
+  _prevRssi     = 0;
+  _candPending  = false;
+  _verifyIdx    = 0;
+}
+
+void Si4703Scanner::begin(uint8_t mode)
+{
+  if (isRunning()) cancel();
+
+  _mode    = mode;
+  _samples = 0;
+  if (_mode != SCAN_SPECTRUM) _table.clear();
+  _startMs = millis();
+  _startTx = _radio.getTransactions();
+
+  // Mute while scanning (DMUTE: 1 = unmuted)
+  _muteWas = _radio.getMute();
+  _radio.setMute(false);
+
+  _progress = _radio.getBandStart();
+  _radio.beginTune(_progress);
+
+  if (_mode != SCAN_SEEK) {
+    _prevRssi    = 0;
+    _candPending = false;
+    _phase = PH_SWEEP;
+  } else {
+    // Seek upward from the band start; a seek never stops on the channel it
+    // starts from, so that one is checked by its RSSI first
+    _phase = PH_START;
+  }
+}
+
+bool Si4703Scanner::poll(void)
+{
+  uint8_t state;
+
+  switch (_phase)
+  {
+    case PH_START:
+      state = _radio.pollTune();
+      if (state == TUNE_TUNING) break;
+
+      if (state == TUNE_DONE && _radio.getTuneRSSI() >= _criteria.rssiMin) {
+        _hit.freq   = _progress;
+        _hit.rssi   = _radio.getTuneRSSI();
+        _hit.stereo = _radio.getTuneST();
+        _hit.pi     = 0;
+        hitFound();
+        break;
+      }
+      seekNext();
+      break;
+
+    case PH_SEEK:
+      state = _radio.pollTune();
+      if (state == TUNE_TUNING) {
+        break;
+      }
+      if (state != TUNE_DONE) { // band limit or timeout: the band is done
+        finish();
+        break;
+      }
+
+      _hit.freq   = _radio.getChannel();
+      _hit.rssi   = _radio.getTuneRSSI();
+      _hit.stereo = _radio.getTuneST();
+      _hit.pi     = 0;
+
+      // SKMODE_WRAP would start over from the bottom of the band
+      if (_hit.freq <= _progress) {
+        finish();
+        break;
+      }
+      _progress = _hit.freq;
+      hitFound();
+      break;
+
+    case PH_SWEEP:
+      // The STATUSRSSI read that sees STC also carries RSSI/ST, and the next
+      // tune is issued in the same poll
+      state = _radio.pollTune();
+      if (state == TUNE_TUNING) break;
+
+      if (state == TUNE_DONE) sweepSample(_progress, _radio.getTuneRSSI(), _radio.getTuneST());
+      else                    sweepSample(_progress, 0, false);
+
+      if (_progress + _radio.getBandSpace() <= _radio.getBandEnd()) {
+        _progress += _radio.getBandSpace();
+        _radio.beginTune(_progress);
+      } else if (_mode == SCAN_SPECTRUM) {
+        finish();
+      } else {
+        sweepFlush();
+        _verifyIdx = 0;
+        verifyNext();
+      }
+      break;
+
+    case PH_VERIFY:
+      state = _radio.pollTune();
+      if (state == TUNE_TUNING) break;
+
+      _hit = _table.at(_verifyIdx);
+      _dwellStartMs = millis();
+      _dwellPollMs  = _dwellStartMs;
+      _phase = PH_DWELL;
+      break;
+
+    case PH_DWELL:
+      if (millis() - _dwellPollMs < PI_POLL_MS) break;
+      _dwellPollMs = millis();
+
+      if (_piDwellMs > 0 && _hit.pi == 0) _hit.pi = _radio.readPI();
+      if (_radio.getST()) _hit.stereo = 1; // pilot detection needs time after tune
+
+      {
+        bool piDone     = (_piDwellMs == 0 || _hit.pi != 0);
+        bool stereoDone = (!_criteria.requireStereo || _hit.stereo || _mode != SCAN_SWEEP);
+        uint16_t limit  = _piDwellMs;
+        if (_mode == SCAN_SWEEP && _criteria.requireStereo && limit < STEREO_DWELL_MS) limit = STEREO_DWELL_MS;
+
+        if ((piDone && stereoDone) || millis() - _dwellStartMs >= limit) dwellDone();
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return isRunning();
+}
+
+void Si4703Scanner::cancel(void)
+{
+  if (!isRunning()) return;
+  _radio.cancelTune();
+  finish();
+}
+
+void Si4703Scanner::seekNext(void)
+{
+  if (_progress >= _radio.getBandEnd()) {
+    finish();
+    return;
+  }
+  _radio.beginSeek(Si4703::SEEK_UP);
+  _phase = PH_SEEK;
+}
+
+void Si4703Scanner::hitFound(void)
+{
+  if (_piDwellMs == 0) {
+    recordHit();
+    return;
+  }
+  _dwellStartMs = millis();
+  _dwellPollMs  = _dwellStartMs;
+  _phase = PH_DWELL;
+}
+
+void Si4703Scanner::recordHit(void)
+{
+  if (_map) {
+    _map->update(_hit.freq, _hit.rssi, _hit.stereo);
+    _map->setPI(_hit.freq, _hit.pi);
+  }
+  _table.add(_hit);
+  seekNext();
+}
+
+// -----------------------------------------------------------------------------
+// Sweep detection. Dead channels (below rssiMin) are rejected immediately;
+// with localPeak a candidate is only accepted once the next channel has
+// shown a lower or equal RSSI.
+// -----------------------------------------------------------------------------
+void Si4703Scanner::sweepSample(int freq, uint8_t rssi, bool stereo)
+{
+  _samples++;
+  if (_map)  _map->update(freq, rssi, stereo);
+  if (_hook) _hook(freq, rssi, stereo);
+  if (_mode == SCAN_SPECTRUM) return;
+
+  if (_candPending) {
+    if (!_criteria.localPeak || _cand.rssi >= rssi) _table.add(_cand);
+    _candPending = false;
+  }
+
+  if (rssi >= _criteria.rssiMin && (!_criteria.localPeak || rssi > _prevRssi)) {
+    _cand.freq   = freq;
+    _cand.rssi   = rssi;
+    _cand.stereo = stereo;
+    _cand.pi     = 0;
+    _candPending = true;
+  }
+
+  _prevRssi = rssi;
+}
+
+void Si4703Scanner::sweepFlush(void)
+{
+  if (_candPending) _table.add(_cand);
+  _candPending = false;
+}
+
+// -----------------------------------------------------------------------------
+// After the sweep, candidates are revisited only if PI or a stereo check is
+// wanted; otherwise the sweep result is final.
+// -----------------------------------------------------------------------------
+void Si4703Scanner::verifyNext(void)
+{
+  if ((_piDwellMs == 0 && !_criteria.requireStereo) || _verifyIdx >= _table.count()) {
+    finish();
+    return;
+  }
+  _progress = _table.at(_verifyIdx).freq;
+  _radio.beginTune(_progress);
+  _phase = PH_VERIFY;
+}
+
+void Si4703Scanner::dwellDone(void)
+{
+  if (_mode != SCAN_SWEEP) {
+    recordHit();
+    return;
+  }
+
+  if (_criteria.requireStereo && !_hit.stereo) {
+    _table.remove(_verifyIdx);
+  } else {
+    if (_map) _map->setPI(_hit.freq, _hit.pi);
+    _table.add(_hit); // same frequency: updates PI/stereo in place
+    _verifyIdx++;
+  }
+  verifyNext();
+}
+
+void Si4703Scanner::finish(void)
+{
+  _phase        = PH_IDLE;
+  _elapsedMs    = millis() - _startMs;
+  _transactions = _radio.getTransactions() - _startTx;
+  _radio.setMute(_muteWas);
+}
@@ -0,0 +1,144 @@
+/*
+ *  Si4703 band scan
+ *
+ *  Walks the band on top of the non-blocking Si4703 tune/seek API and
+ *  collects the stations found into a fixed-capacity table (no heap).
+ *  Two strategies: hardware seek (chip thresholds decide) and a software
+ *  sweep that tunes every channel and applies its own criteria. The sweep
+ *  can also run bare (SCAN_SPECTRUM), only reporting each channel's RSSI.
+ *  The table is kept sorted by frequency; when it is full, the weakest
+ *  station gives way to a stronger one.
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef Si4703Scan_h
+#define Si4703Scan_h
+
+#include "Arduino.h"
+#include "Si4703.h"
+#include "BandMap.h"
+
+// Scan strategies
+static const uint8_t 	SCAN_SEEK		= 0;	// Hardware seek (SKMODE_STOP) from band start to band end
+static const uint8_t 	SCAN_SWEEP		= 1;	// Software sweep: tune every channel, RSSI from the STC read
+static const uint8_t 	SCAN_SPECTRUM	= 2;	// Sweep only, reporting every channel (station table untouched)
+
+// Called for every channel a sweep lands on (SCAN_SWEEP / SCAN_SPECTRUM)
+typedef void (*ScanSampleHook)(int freq, uint8_t rssi, bool stereo);
+
+//------------------------------------------------------------------------------------------------------------
+
+// One station found by a scan (stored as-is in Preferences)
+struct StationInfo
+{
+  uint16_t freq;    // Frequency (10kHz units)
+  uint8_t  rssi;    // RSSI at the time of the scan
+  uint8_t  stereo;  // 1 = stereo pilot seen
+  uint16_t pi;      // RDS Programme Identification (0 = unknown)
+};
+
+// Station detection criteria of the software sweep (SCAN_SWEEP)
+struct ScanCriteria
+{
+  uint8_t rssiMin;        // Channels below this are rejected right after tuning
+                          // (SCAN_SEEK: threshold for the band-start channel)
+  bool    localPeak;      // Keep only RSSI peaks (rejects adjacent-channel splatter)
+  bool    requireStereo;  // Drop stations with no stereo pilot after the dwell
+};
+
+class StationTable
+{
+  public:
+    static const uint8_t CAPACITY = 32;
+
+    StationTable();
+
+    void  clear(void);
+    bool  add(const StationInfo& st);   // Insert sorted by freq (update if present)
+    void  remove(uint8_t i);            // Remove entry i
+    int   find(int freq) const;         // Index of freq, or -1
+    int   next(int freq, int dir) const;// Index of the nearest station above (dir>0) / below freq, or -1
+
+    uint8_t            count(void) const { return _count; }
+    const StationInfo& at(uint8_t i) const { return _st[i]; }
+
+    // Raw access for persistence
+    const StationInfo* data(void) const { return _st; }
+    size_t size(void) const { return _count * sizeof(StationInfo); }
+    void  load(const StationInfo* src, uint8_t n);
+
+  private:
+    StationInfo _st[CAPACITY];
+    uint8_t     _count;
+};
+
+class Si4703Scanner
+{
+  public:
+    Si4703Scanner(Si4703& radio, StationTable& table);
+
+    void  begin(uint8_t mode = SCAN_SEEK); // Start a scan (audio muted while running)
+    bool  poll(void);                      // Advance; false once finished
+    void  cancel(void);                    // Abort, keeping stations found so far
+    bool  isRunning(void) const { return _phase != PH_IDLE; }
+
+    void  setPiDwell(uint16_t ms) { _piDwellMs = ms; } // Time to wait for RDS PI per hit (0 = skip)
+    void  setCriteria(const ScanCriteria& c) { _criteria = c; } // SCAN_SWEEP detection
+    void  setBandMap(BandMap* map) { _map = map; } // Also record every channel seen (optional)
+    void  setSampleHook(ScanSampleHook hook) { _hook = hook; } // Per-channel callback (optional)
+
+    int      getProgress(void) const { return _progress; }  // Channel being examined
+    uint32_t getElapsedMs(void) const { return _elapsedMs; } // Duration of the last scan
+    uint32_t getTransactions(void) const { return _transactions; } // I2C transactions of the last scan
+    uint16_t getSamples(void) const { return _samples; }     // Channels swept by the current/last scan
+
+  private:
+    static const uint8_t  PH_IDLE   = 0;
+    static const uint8_t  PH_START  = 1;  // tuning to band start
+    static const uint8_t  PH_SEEK   = 2;  // hardware seek in flight
+    static const uint8_t  PH_DWELL  = 3;  // waiting for PI/stereo on a hit
+    static const uint8_t  PH_SWEEP  = 4;  // tuning the next channel of the sweep
+    static const uint8_t  PH_VERIFY = 5;  // tuning back to a sweep candidate
+
+    static const uint16_t PI_POLL_MS      = 40;  // RDS group rate is ~11.4/s
+    static const uint16_t STEREO_DWELL_MS = 300; // pilot detection after tune
+
+    void  seekNext(void);
+    void  hitFound(void);                  // Dwell for PI, or record right away
+    void  recordHit(void);
+    void  sweepSample(int freq, uint8_t rssi, bool stereo);
+    void  sweepFlush(void);
+    void  verifyNext(void);
+    void  dwellDone(void);
+    void  finish(void);
+
+    Si4703&       _radio;
+    StationTable& _table;
+    BandMap*      _map;
+    ScanSampleHook _hook;
+
+    uint8_t       _phase;
+    uint8_t       _mode;
+    bool          _muteWas;
+    uint16_t      _piDwellMs;
+    StationInfo   _hit;
+    ScanCriteria  _criteria;
+
+    // Sweep state: the last candidate waits for its right neighbour's RSSI
+    uint8_t       _prevRssi;
+    bool          _candPending;
+    StationInfo   _cand;
+    uint8_t       _verifyIdx;
+    unsigned long _dwellStartMs;
+    unsigned long _dwellPollMs;
+    int           _progress;
+    uint16_t      _samples;
+
+    unsigned long _startMs;
+    uint32_t      _startTx;
+    uint32_t      _elapsedMs;
+    uint32_t      _transactions;
+};
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ *  PI-keyed station metadata cache
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#include <string.h>
+#include "StationCache.h"
+
+StationCache::StationCache()
+{
+  _evictions = 0;
+  clear();
+}
+
+void StationCache::clear(void)
+{
+  memset(_slot, 0, sizeof(_slot));
+  _count = 0;
+  _clock = 0;
+  _dirty = true;
+}
+
+// PIs of one country share the top nibble: mix before masking
+uint8_t StationCache::home(uint16_t pi) const
+{
+  return (uint8_t)(((pi * 0x9E37u) >> 8) & (SLOTS - 1));
+}
+
+int StationCache::slotOf(uint16_t pi) const
+{
+  if (pi == 0) return -1;
+
+  uint8_t i = home(pi);
+  for (int n = 0; n < SLOTS; n++) {
+    if (_slot[i].pi == pi) return i;
+    if (_slot[i].pi == 0)  return -1;
+    i = (i + 1) & (SLOTS - 1);
+  }
+  return -1;
+}
+
+const StationCache::Entry* StationCache::find(uint16_t pi) const
+{
+  int i = slotOf(pi);
+  return i < 0 ? 0 : &_slot[i];
+}
+
+void StationCache::touch(uint16_t pi)
+{
+  int i = slotOf(pi);
+  if (i >= 0) _slot[i].stamp = ++_clock;
+}
+
+void StationCache::store(uint16_t pi, const char* ps, uint8_t pty, const char* rt)
+{
+  if (pi == 0) return;
+
+  int i = slotOf(pi);
+  if (i < 0) {
+    if (_count >= MAX_ENTRIES) evictOldest();
+
+    i = home(pi);
+    while (_slot[i].pi != 0) i = (i + 1) & (SLOTS - 1);
+
+    memset(&_slot[i], 0, sizeof(Entry));
+    _slot[i].pi = pi;
+    _count++;
+    _dirty = true;
+  }
+
+  Entry& e = _slot[i];
+  e.stamp = ++_clock;
+
+  if (pty != e.pty) {
+    e.pty = pty;
+    _dirty = true;
+  }
+  if (ps && strncmp(e.ps, ps, PS_LEN) != 0) {
+    memcpy(e.ps, ps, PS_LEN);
+    e.ps[PS_LEN] = 0;
+    _dirty = true;
+  }
+  // RT changes every few seconds: kept in RAM, written only along with a
+  // PS/PTY/new-station change, so the blob is not rewritten all the time
+  if (rt && rt[0] && strncmp(e.rt, rt, RT_LEN) != 0) {
+    strncpy(e.rt, rt, RT_LEN);
+    e.rt[RT_LEN] = 0;
+  }
+}
+
+void StationCache::evictOldest(void)
+{
+  int oldest = -1;
+  for (int i = 0; i < SLOTS; i++) {
+    if (_slot[i].pi == 0) continue;
+    if (oldest < 0 || (uint16_t)(_clock - _slot[i].stamp) > (uint16_t)(_clock - _slot[oldest].stamp)) oldest = i;
+  }
+  if (oldest < 0) return;
+
+  removeSlot(oldest);
+  _evictions++;
+}
+
+// -----------------------------------------------------------------------------
+// Backward-shift deletion: entries after the hole that could live earlier
+// move up, so lookups never need tombstones.
+// -----------------------------------------------------------------------------
+void StationCache::removeSlot(int i)
+{
+  int hole = i;
+  int j    = i;
+
+  for (;;) {
+    j = (j + 1) & (SLOTS - 1);
+    if (_slot[j].pi == 0) break;
+
+    // Distance of j from its home vs. from the hole
+    int h = home(_slot[j].pi);
+    if (((j - h) & (SLOTS - 1)) >= ((j - hole) & (SLOTS - 1))) {
+      _slot[hole] = _slot[j];
+      hole = j;
+    }
+  }
+
+  memset(&_slot[hole], 0, sizeof(Entry));
+  _count--;
+  _dirty = true;
+}
+
+void StationCache::rebuild(void)
+{
+  _count = 0;
+  _clock = 0;
+  for (int i = 0; i < SLOTS; i++) {
+    if (_slot[i].pi == 0) continue;
+    _count++;
+    _slot[i].ps[PS_LEN] = 0;
+    _slot[i].rt[RT_LEN] = 0;
+
+    // Continue the clock after the newest stamp
+    if ((int16_t)(_slot[i].stamp - _clock) > 0) _clock = _slot[i].stamp;
+  }
+  _dirty = false;
+}
@@ -0,0 +1,70 @@
+/*
+ *  PI-keyed station metadata cache
+ *
+ *  Remembers PS name, PTY and the last RadioText of the stations heard, so
+ *  a retune can show the name at once instead of after seconds of RDS.
+ *  Open-addressing hash table keyed by PI (linear probing, backward-shift
+ *  deletion) in static memory; once MAX_ENTRIES are used the least recently
+ *  used station is evicted. Lookup by frequency goes through the band map,
+ *  which records the PI of each channel. Persisted as one blob.
+ *  No Arduino dependency.
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#ifndef StationCache_h
+#define StationCache_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+class StationCache
+{
+  public:
+    static const uint8_t SLOTS       = 16;  // power of two
+    static const uint8_t MAX_ENTRIES = 12;  // keeps probe sequences short
+    static const uint8_t PS_LEN      = 8;
+    static const uint8_t RT_LEN      = 64;
+
+    struct Entry
+    {
+      uint16_t pi;                  // 0 = free slot
+      uint16_t stamp;               // last use (cache clock)
+      uint8_t  pty;
+      char     ps[PS_LEN + 1];
+      char     rt[RT_LEN + 1];      // "" = none
+    };
+
+    StationCache();
+
+    void  clear(void);
+    const Entry* find(uint16_t pi) const;        // Entry of pi, or 0
+    void  touch(uint16_t pi);                    // Mark as just used (tuned to)
+    void  store(uint16_t pi, const char* ps, uint8_t pty, const char* rt); // Insert or update
+
+    uint8_t count(void) const { return _count; }
+    uint32_t getEvictions(void) const { return _evictions; }
+
+    bool  isDirty(void) const { return _dirty; } // New station, PS or PTY changed (not RT alone)
+    void  clearDirty(void) { _dirty = false; }
+
+    // Raw access for persistence (load straight into raw(), then rebuild())
+    const Entry* data(void) const { return _slot; }
+    Entry*       raw(void) { return _slot; }
+    size_t size(void) const { return sizeof(_slot); }
+    void  rebuild(void);                         // Recount and restart the clock after a load
+
+  private:
+    int   slotOf(uint16_t pi) const;             // Slot holding pi, or -1
+    uint8_t home(uint16_t pi) const;
+    void  removeSlot(int i);
+    void  evictOldest(void);
+
+    Entry    _slot[SLOTS];
+    uint8_t  _count;
+    uint16_t _clock;
+    uint32_t _evictions;
+    bool     _dirty;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ *  RDS capture replay (Linux host)
+ *
+ *  Feeds a capture recorded from the radio's UART (firmware built with
+ *  -DRDS_LOG_ENABLED=1, e.g. `cat /dev/ttyACM0 > station.bin`) through the
+ *  same RdsDecoder the firmware uses, and reports what was decoded and how
+ *  fast. Text log lines in the capture are skipped by the frame parser.
+ *
+ *  Build (from the repository root):
+ *    g++ -std=c++11 -O2 -Wall -Isi4703 tools/rds_replay.cpp \
+ *        si4703/RdsDecoder.cpp si4703/AfTable.cpp -o rds_replay
+ *
+ *  Usage:
+ *    rds_replay <capture> [-p strict|block|vote] [-n repeats] [-e "EXPECTED"]
+ *
+ *  -p  acceptance policy (default: vote, as in the firmware)
+ *  -n  decode the capture this many times for the throughput figure
+ *  -e  exit with 1 unless the final PS equals EXPECTED (regression check)
+ *
+ *  https://www.facebook.com/groups/esp32radio
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "RdsGroup.h"
+#include "RdsLog.h"
+#include "RdsDecoder.h"
+
+// -----------------------------------------------------------------------------
+// Policies selectable from the command line
+// -----------------------------------------------------------------------------
+static bool parsePolicy(const char* name, RdsPolicy& p)
+{
+  if (strcmp(name, "strict") == 0) {
+    p.mode = RDS_DROP_GROUP;
+    for (int i = 0; i < 4; i++) p.maxLevel[i] = RDS_BLER_NONE;
+  } else if (strcmp(name, "block") == 0) {
+    p.mode = RDS_ACCEPT_BLOCK;
+    for (int i = 0; i < 4; i++) p.maxLevel[i] = RDS_BLER_1_2;
+  } else if (strcmp(name, "vote") == 0) {
+    // Same as RDS_POLICY in radio-fm20x4.ino
+    p.mode = RDS_ACCEPT_VOTE;
+    p.maxLevel[0] = RDS_BLER_3_5;
+    p.maxLevel[1] = RDS_BLER_1_2;
+    p.maxLevel[2] = RDS_BLER_3_5;
+    p.maxLevel[3] = RDS_BLER_3_5;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static void usage(void)
+{
+  fprintf(stderr, "usage: rds_replay <capture> [-p strict|block|vote] [-n repeats] [-e \"EXPECTED\"]\n");
+}
+
+int main(int argc, char** argv)
+{
+  const char* path     = 0;
+  const char* expected = 0;
+  long        repeats  = 1;
+  RdsPolicy   policy;
+  parsePolicy("vote", policy);
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      if (!parsePolicy(argv[++i], policy)) {
+        usage();
+        return 2;
+      }
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      repeats = atol(argv[++i]);
+      if (repeats < 1) repeats = 1;
+    } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+      expected = argv[++i];
+    } else if (!path && argv[i][0] != '-') {
+      path = argv[i];
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if (!path) {
+    usage();
+    return 2;
+  }
+
+  // --- Parse the capture into groups -----------------------------------------
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 2;
+  }
+
+  std::vector<RdsGroup> groups;
+  RdsLog::Parser parser;
+  RdsGroup g;
+  int c;
+  long bytes = 0;
+  while ((c = fgetc(f)) != EOF) {
+    bytes++;
+    if (parser.feed((uint8_t)c, g)) groups.push_back(g);
+  }
+  fclose(f);
+
+  printf("Capture: %s, %ld B, %lu frames, %lu CRC errors\n", path, bytes,
+         (unsigned long)parser.getFrames(), (unsigned long)parser.getCrcErrors());
+  if (groups.empty()) {
+    printf("No RDS frames found\n");
+    return expected ? 1 : 0;
+  }
+
+  uint32_t spanMs = groups.back().ms - groups.front().ms;
+  printf("Air time: %.1f s (%.1f groups/s on air)\n", spanMs / 1000.0,
+         spanMs ? groups.size() * 1000.0 / spanMs : 0.0);
+
+  // --- First pass: report decode events in capture time ----------------------
+  RdsDecoder dec;
+  dec.setPolicy(policy);
+
+  uint16_t pi = 0, psVer = dec.getPSVersion(), rtVer = dec.getRTVersion(), ctVer = 0;
+  uint32_t firstPsMs = 0;
+  bool     psSeen = false;
+
+  for (size_t i = 0; i < groups.size(); i++) {
+    dec.feed(groups[i]);
+    double t = (groups[i].ms - groups.front().ms) / 1000.0;
+
+    if (dec.getPI() != pi) {
+      pi = dec.getPI();
+      printf("%8.2fs  PI  %04X  PTY %u  TP %d\n", t, pi, dec.getPTY(), dec.getTP());
+    }
+    if (dec.hasPS() && dec.getPSVersion() != psVer) {
+      psVer = dec.getPSVersion();
+      if (!psSeen) firstPsMs = groups[i].ms - groups.front().ms;
+      psSeen = true;
+      printf("%8.2fs  PS  '%s'\n", t, dec.getPS());
+    }
+    if (dec.getRT()[0] && dec.getRTVersion() != rtVer) {
+      rtVer = dec.getRTVersion();
+      printf("%8.2fs  RT  '%s'\n", t, dec.getRT());
+    }
+    if (dec.hasCT() && dec.getCTVersion() != ctVer) {
+      ctVer = dec.getCTVersion();
+      printf("%8.2fs  CT  %lu UTC, offset %+d min\n", t, (unsigned long)dec.getCTUtc(), dec.getCTOffset() * 30);
+    }
+  }
+
+  const AfList* af = dec.getAF();
+  printf("Groups: %lu fed, %lu accepted, %lu rejected; CT %lu accepted, %lu rejected\n",
+         (unsigned long)dec.getGroups(), (unsigned long)dec.getAccepted(), (unsigned long)dec.getRejected(),
+         (unsigned long)dec.getCTAccepted(), (unsigned long)dec.getCTRejected());
+  printf("AF: %u", af ? af->count : 0);
+  for (int i = 0; af && i < af->count; i++) printf(" %.1f", af->freq(i) / 100.0);
+  printf("\n");
+  if (psSeen) printf("PS complete after %.2f s of air time\n", firstPsMs / 1000.0);
+
+  // --- Throughput: decode the whole capture repeatedly ----------------------
+  uint32_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (long r = 0; r < repeats; r++) {
+    RdsDecoder bench;
+    bench.setPolicy(policy);
+    for (size_t i = 0; i < groups.size(); i++) bench.feed(groups[i]);
+    sink += bench.getAccepted();
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  double total = (double)groups.size() * repeats;
+  printf("Decode: %.0f groups in %.3f ms = %.2f Mgroups/s (check %lu)\n",
+         total, sec * 1000.0, sec > 0 ? total / sec / 1e6 : 0.0, (unsigned long)sink);
+
+  if (expected) {
+    bool ok = dec.hasPS() && strcmp(dec.getPS(), expected) == 0;
+    printf("Expected PS '%s': %s\n", expected, ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+  }
+  return 0;
+}